@@ -336,6 +336,9 @@ static void compute_sycl_gtx(void* dev, int w, int h, int samps, Ray cameraRay,
   using namespace ns_sycl_gtx;
 
   queue q(*static_cast<device*>(dev));  // NOLINT
+#ifdef SYCL_GTX
+  q.set_compile_options(compile_options::fast_math());
+#endif
 
   auto spheres_tmp = buffer<float16>(range<1>(ns_sycl_gtx::numSpheres));
   {
@@ -393,17 +396,17 @@ static void compute_sycl_gtx(void* dev, int w, int h, int samps, Ray cameraRay,
       seeds_tmp.emplace_back(length);
       starts[k] = start;
 
-      auto seeds = seeds_tmp.back()
-                       .get_access<access::mode::discard_write,
-                                   access::target::host_buffer>();
+      auto seeds_acc = seeds_tmp.back()
+                           .get_access<access::mode::discard_write,
+                                       access::target::host_buffer>();
+      auto seeds = seeds_acc.data();
 
       for (int y = 0; y < height; ++y) {
         Xi[2] = y * y * y;
         for (int x = 0; x < w; ++x) {
-          cl::sycl::cl_uint2 seed;
+          auto& seed = seeds[y * w + x];
           seed.x() = static_cast<::cl_uint>(get_random(Xi));
           seed.y() = static_cast<::cl_uint>(get_random(Xi));
-          seeds[y * w + x] = seed;
         }
       }
     }
@@ -497,7 +500,7 @@ static void compute_sycl_gtx(void* dev, int w, int h, int samps, Ray cameraRay,
     });
   }
 
-  auto assign = [](::Vec& target, cl::sycl::cl_float3& data) {
+  auto assign = [](::Vec& target, const cl::sycl::cl_float3& data) {
     target.x = static_cast<float_type>(data.x());
     target.y = static_cast<float_type>(data.y());
     target.z = static_cast<float_type>(data.z());
@@ -507,8 +510,9 @@ static void compute_sycl_gtx(void* dev, int w, int h, int samps, Ray cameraRay,
 #ifndef NDEBUG
     cout << "Waiting for kernel to finish ..." << endl;
 #endif
-    auto c =
+    auto c_acc =
         colors[k].get_access<access::mode::read, access::target::host_buffer>();
+    auto c = c_acc.data();
 
 #ifndef NDEBUG
     cout << "Copying results ..." << endl;
@@ -519,8 +523,7 @@ static void compute_sycl_gtx(void* dev, int w, int h, int samps, Ray cameraRay,
       int i = (y - start) * w;
       int ri = (h - y - 1) * w;  // Picture is upside down
       for (int x = 0; x < w; ++x) {
-        auto& ci = c[i];
-        assign(cVecOut[ri], ci);
+        assign(cVecOut[ri], c[i]);
 
         ++i;
         ++ri;
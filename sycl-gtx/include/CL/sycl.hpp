@@ -4,19 +4,36 @@
 #define CL_SYCL_LANGUAGE_VERSION 120
 
 #include "SYCL/accessors/buffer.h"
+#include "SYCL/accessors/image.h"
 #include "SYCL/accessors/local.h"
 #include "SYCL/buffer.h"
+#include "SYCL/buffer_pool.h"
+#include "SYCL/command_graph.h"
 #include "SYCL/command_group.h"
+#include "SYCL/compile_options.h"
 #include "SYCL/context.h"
 #include "SYCL/device.h"
+#include "SYCL/distributed_queue.h"
+#include "SYCL/flush_policy.h"
 #include "SYCL/functions/common.h"
+#include "SYCL/half.h"
 #include "SYCL/handler.h"
+#include "SYCL/host_accessor_future.h"
+#include "SYCL/image.h"
 #include "SYCL/info.h"
 #include "SYCL/kernel.h"
+#include "SYCL/mapped_file.h"
 #include "SYCL/platform.h"
 #include "SYCL/program.h"
 #include "SYCL/queue.h"
 #include "SYCL/ranges.h"
+#include "SYCL/sampler.h"
+#include "SYCL/soa_buffer.h"
+#include "SYCL/streaming_queue.h"
+#include "SYCL/svm.h"
+#include "SYCL/trace_memo.h"
+#include "SYCL/vectors/half_storage.h"
+#include "SYCL/vectors/packed.h"
 #include "SYCL/vectors/swizzled_vec.h"
 #include "SYCL/vectors/vec.h"
 #include "SYCL/workitem_functions.h"
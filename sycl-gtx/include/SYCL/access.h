@@ -40,7 +40,9 @@ enum class target {
   /** access image immediately on the host */
   host_image,
   /** access an array of images on device */
-  image_array
+  image_array,
+  /** pass a shared virtual memory allocation as a pointer (extension) */
+  svm
 };
 
 static debug& operator<<(debug& d, mode m) {
@@ -93,6 +95,9 @@ static debug& operator<<(debug& d, target t) {
     case target::image_array:
       str += "image_array";
       break;
+    case target::svm:
+      str += "svm";
+      break;
   }
   d << str;
   return d;
@@ -21,6 +21,8 @@ namespace detail {
 template <typename DataType, int dimensions>
 class accessor_buffer {
  protected:
+  friend class ::cl::sycl::handler;
+
   buffer<DataType, dimensions>* buf;
   handler* commandGroupHandler;
   range<dimensions> offset;
@@ -69,9 +69,15 @@ SYCL_ACCESSOR_CLASS(target == access::target::constant_buffer ||
     return base_acc_buffer::get_buffer_object();
   }
 
+  /** Host data of the buffer, only to be used in host tasks */
+  typename base_host_data<DataType>::type* get_host_pointer() const {
+    return base_acc_buffer::access_host_data();
+  }
+
   return_t operator[](id<dimensions> index) const {
     auto resource_name = kernel_ns::register_resource(*this);
-    return return_t(resource_name + "[" + data_ref::get_name(index) + "]");
+    return acc_device_element<DataType>::get(resource_name,
+                                             data_ref::get_name(index));
   }
 
  private:
@@ -35,7 +35,7 @@ namespace detail {
 template <int level, typename DataType, int dimensions, access::mode mode>
 class accessor_host_ref {
  protected:
-  using Lower = accessor_host_ref<dimensions - 1, DataType, dimensions, mode>;
+  using Lower = accessor_host_ref<level - 1, DataType, dimensions, mode>;
   SYCL_ACCESSOR_HOST_REF_CONSTRUCTOR();
 
  public:
@@ -53,6 +53,9 @@ class accessor_host_ref<1, DataType, dimensions, mode> {
 
  public:
   typename base_host_data<DataType>::type& operator[](int index) {
+    if (dimensions == 1) {
+      return parent->access_host_data()[index];
+    }
     // http://stackoverflow.com/questions/7367770
     rang[dimensions - 1] = index;
     index = 0;
@@ -76,6 +79,11 @@ SYCL_ACCESSOR_CLASS(target == access::target::host_buffer)
       accessor_host_ref<dimensions, DataType, dimensions, mode>;
 
  public:
+  using value_type = typename base_host_data<DataType>::type;
+  using pointer_t =
+      typename std::conditional<mode == access::mode::read, const value_type*,
+                                value_type*>::type;
+
   accessor_detail(buffer<DataType, dimensions> & bufferRef,
                   range<dimensions> offset, range<dimensions> range)
       : base_acc_buffer(bufferRef, nullptr, offset, range),
@@ -114,6 +122,42 @@ SYCL_ACCESSOR_CLASS(target == access::target::host_buffer)
   ~accessor_detail() {
     synchronizer::remove(this, base_acc_buffer::buf);
   }
+
+  // Contiguous access to the whole buffer, for use in plain host loops
+  // Dimension 0 is the contiguous one, same as with operator[]
+
+  /** @return pointer to the first element of the buffer */
+  pointer_t get_pointer() const {
+    return base_acc_buffer::access_host_data();
+  }
+  pointer_t data() const {
+    return get_pointer();
+  }
+  /** @return number of elements in the buffer */
+  ::size_t size() const {
+    return base_acc_buffer::buf->get_count();
+  }
+  pointer_t begin() const {
+    return get_pointer();
+  }
+  pointer_t end() const {
+    return get_pointer() + size();
+  }
+
+  /** @return pointer to the contiguous row of range(0) elements at y */
+  template <int num = dimensions>
+  pointer_t row(::size_t y,
+                typename std::enable_if<num == 2>::type* = nullptr) const {
+    return get_pointer() + y * base_acc_buffer::access_buffer_range(0);
+  }
+  /** @return pointer to the contiguous row of range(0) elements at (y, z) */
+  template <int num = dimensions>
+  pointer_t row(::size_t y, ::size_t z,
+                typename std::enable_if<num == 3>::type* = nullptr) const {
+    return get_pointer() +
+           (y + z * base_acc_buffer::access_buffer_range(1)) *
+               base_acc_buffer::access_buffer_range(0);
+  }
 };
 
 }  // namespace detail
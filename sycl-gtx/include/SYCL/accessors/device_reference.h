@@ -21,6 +21,16 @@ struct acc_device_return {
   using type = data_ref;
 };
 
+/** Element of a buffer in kernel source */
+template <typename DataType>
+struct acc_device_element {
+  using type = typename acc_device_return<DataType>::type;
+  static type get(const string_class& resource_name,
+                  const string_class& index) {
+    return type(resource_name + "[" + index + "]");
+  }
+};
+
 template <int level, typename DataType, int dimensions, access::mode mode,
           access::target target>
 struct subscript_helper {
@@ -102,7 +112,7 @@ class accessor_device_ref<1, DataType, dimensions, mode, target> {
       multiplier *= parent->access_buffer_range(i);
     }
     auto resource_name = kernel_ns::register_resource(*parent);
-    return subscript_return_t(resource_name + "[" + ind + "]");
+    return acc_device_element<DataType>::get(resource_name, ind);
   }
 
  public:
@@ -0,0 +1,259 @@
+#pragma once
+
+// 3.4.6.5 Image accessors
+
+#include "SYCL/access.h"
+#include "SYCL/accessor.h"
+#include "SYCL/detail/common.h"
+#include "SYCL/detail/data_ref.h"
+#include "SYCL/detail/src_handlers/register_resource.h"
+#include "SYCL/detail/synchronizer.h"
+#include "SYCL/error_handler.h"
+#include "SYCL/image.h"
+#include "SYCL/ranges/id.h"
+#include "SYCL/sampler.h"
+#include "SYCL/vectors/vec.h"
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+/** Channel type of the pixels of image accessors */
+template <typename DataType>
+struct image_pixel;
+
+template <typename dataT>
+struct image_pixel<vectors::cl_base<dataT, 4, 4>> {
+  using type = dataT;
+};
+template <typename dataT>
+struct image_pixel<vec<dataT, 4>> {
+  using type = dataT;
+};
+
+/** Suffix of the image built-in functions for the channel type */
+template <typename dataT>
+struct image_suffix;
+
+#define SYCL_IMAGE_SUFFIX(type, suffix) \
+  template <>                           \
+  struct image_suffix<type> {           \
+    static string_class get() {         \
+      return suffix;                    \
+    }                                   \
+  };
+
+SYCL_IMAGE_SUFFIX(float, "f")
+SYCL_IMAGE_SUFFIX(int, "i")
+SYCL_IMAGE_SUFFIX(unsigned int, "ui")
+
+#undef SYCL_IMAGE_SUFFIX
+
+/**
+ * Device image accessors.
+ * Pixels are read with read_image and written with write_image,
+ * optionally through a sampler.
+ */
+SYCL_ACCESSOR_CLASS(target == access::target::image) {
+ private:
+  using element_t = typename image_pixel<DataType>::type;
+  using return_t = vectors::expression<element_t, 4>;
+
+  image<dimensions>* img;
+
+  void* resource() const final {
+    return static_cast<buffer_base*>(img);
+  }
+
+  ::size_t argument_size() const final {
+    return sizeof(cl_mem);
+  }
+
+  // Integer coordinates of the pixel, 3D images take a 4-element vector
+  static string_class get_coords(const id<dimensions>& index) {
+    string_class coords = data_ref::open_parenthesis +
+                          (dimensions == 2 ? "int2)(" : "int4)(") +
+                          index.get(0).name;
+    for (int i = 1; i < dimensions; ++i) {
+      coords += ", " + index.get(i).name;
+    }
+    if (dimensions == 3) {
+      coords += ", 0";
+    }
+    return coords + ')';
+  }
+
+  return_t read_pixel(const string_class& sampler_name,
+                      const string_class& coords) const {
+    auto resource_name = kernel_ns::register_resource(*this);
+    return return_t("read_image" + image_suffix<element_t>::get() + '(' +
+                    resource_name + ", " + sampler_name + coords + ')');
+  }
+
+  void write_pixel(const string_class& coords, const data_ref& color) const {
+    auto resource_name = kernel_ns::register_resource(*this);
+    kernel_add("write_image" + image_suffix<element_t>::get() + '(' +
+               resource_name + ", " + coords + ", " + color.name + ')');
+  }
+
+ public:
+  accessor_detail(image<dimensions> & imageRef, handler & commandGroupHandler)
+      : img(&imageRef) {}
+
+  cl_mem get_cl_mem_object() const final {
+    return img->device_data.get();
+  }
+
+  /** Reads the pixel at integer coordinates, without filtering */
+  return_t read(const id<dimensions>& index) const {
+    return read_pixel("", get_coords(index));
+  }
+  return_t read(const data_ref& coords) const {
+    return read_pixel("", coords.name);
+  }
+
+  /** Reads at the coordinates, which are floating point for filtering */
+  return_t read(const data_ref& coords, const sampler& smpl) const {
+    return read_pixel(kernel_ns::register_sampler(smpl) + ", ", coords.name);
+  }
+  return_t read(const id<dimensions>& index, const sampler& smpl) const {
+    return read_pixel(kernel_ns::register_sampler(smpl) + ", ",
+                      get_coords(index));
+  }
+
+  void write(const id<dimensions>& index, const data_ref& color) const {
+    write_pixel(get_coords(index), color);
+  }
+  void write(const data_ref& coords, const data_ref& color) const {
+    write_pixel(coords.name, color);
+  }
+};
+
+/**
+ * Host image accessors.
+ * Pixels are read and written in the host data of the image,
+ * in the channel type of the image without conversion,
+ * so the host type of the data type has to be as large as a pixel,
+ * such as cl_float4 for rgba fp32 or cl_uchar4 for rgba unorm_int8.
+ * Commands using the image are held back while the accessor exists.
+ */
+SYCL_ACCESSOR_CLASS(target == access::target::host_image) {
+ private:
+  using pixel_t = typename base_host_data<DataType>::type;
+  using pointer_t =
+      typename std::conditional<mode == access::mode::read, const pixel_t*,
+                                pixel_t*>::type;
+
+  image<dimensions>* img;
+
+  // Dimension 0 is contiguous
+  ::size_t get_index(const id<dimensions>& index) const {
+    ::size_t linear = 0;
+    ::size_t multiplier = 1;
+    for (int i = 0; i < dimensions; ++i) {
+      linear += static_cast<::size_t>(index.get(i)) * multiplier;
+      multiplier *= img->region[i];
+    }
+    return linear;
+  }
+
+ public:
+  explicit accessor_detail(image<dimensions> & imageRef) : img(&imageRef) {
+    if (sizeof(pixel_t) != img->get_element_size()) {
+      detail::error::report(CL_INVALID_IMAGE_FORMAT_DESCRIPTOR);
+    }
+    if (mode != access::mode::read && img->is_read_only) {
+      detail::error::report(error::code::TRYING_TO_WRITE_READ_ONLY_BUFFER);
+    }
+    synchronizer::add(this, img);
+  }
+  accessor_detail(const accessor_detail& copy) : img(copy.img) {
+    synchronizer::add(this, img);
+  }
+  accessor_detail& operator=(const accessor_detail&) = delete;
+
+  ~accessor_detail() {
+    synchronizer::remove(this, img);
+  }
+
+  pixel_t read(const id<dimensions>& index) const {
+    return get_pointer()[get_index(index)];
+  }
+
+  void write(const id<dimensions>& index, const pixel_t& color) const {
+    static_assert(mode != access::mode::read,
+                  "Cannot write through a read accessor");
+    get_pointer()[get_index(index)] = color;
+  }
+
+  /** @return pointer to the first pixel, dimension 0 being contiguous */
+  pointer_t get_pointer() const {
+    return static_cast<pixel_t*>(img->host_data.get());
+  }
+
+  /** @return number of pixels in the image */
+  ::size_t size() const {
+    return img->get_count();
+  }
+};
+
+}  // namespace detail
+
+#if MSVC_2013_OR_LOWER
+#define SYCL_ADD_ACCESSOR_IMAGE(mode)                                     \
+  SYCL_ADD_ACCESSOR(mode, access::target::image) {                        \
+    using Base = detail::accessor_detail<DataType, dimensions, mode,      \
+                                         access::target::image>;          \
+                                                                          \
+   public:                                                                \
+    accessor(image<dimensions>& imageRef, handler& commandGroupHandler)   \
+        : Base(imageRef, commandGroupHandler) {}                          \
+  };
+#else
+#define SYCL_ADD_ACCESSOR_IMAGE(mode)                                \
+  SYCL_ADD_ACCESSOR(mode, access::target::image) {                   \
+    using Base = detail::accessor_detail<DataType, dimensions, mode, \
+                                         access::target::image>;     \
+                                                                     \
+   public:                                                           \
+    using Base::Base;                                                \
+  };
+#endif
+
+// Kernels can either read or write an image
+SYCL_ADD_ACCESSOR_IMAGE(access::mode::read)
+SYCL_ADD_ACCESSOR_IMAGE(access::mode::write)
+SYCL_ADD_ACCESSOR_IMAGE(access::mode::discard_write)
+
+#undef SYCL_ADD_ACCESSOR_IMAGE
+
+#if MSVC_2013_OR_LOWER
+#define SYCL_ADD_ACCESSOR_HOST_IMAGE(mode)                               \
+  SYCL_ADD_ACCESSOR(mode, access::target::host_image) {                  \
+    using Base = detail::accessor_detail<DataType, dimensions, mode,     \
+                                         access::target::host_image>;    \
+                                                                         \
+   public:                                                               \
+    explicit accessor(image<dimensions>& imageRef) : Base(imageRef) {}   \
+  };
+#else
+#define SYCL_ADD_ACCESSOR_HOST_IMAGE(mode)                            \
+  SYCL_ADD_ACCESSOR(mode, access::target::host_image) {               \
+    using Base = detail::accessor_detail<DataType, dimensions, mode,  \
+                                         access::target::host_image>; \
+                                                                      \
+   public:                                                            \
+    using Base::Base;                                                 \
+  };
+#endif
+
+SYCL_ADD_ACCESSOR_HOST_IMAGE(access::mode::read)
+SYCL_ADD_ACCESSOR_HOST_IMAGE(access::mode::write)
+SYCL_ADD_ACCESSOR_HOST_IMAGE(access::mode::read_write)
+SYCL_ADD_ACCESSOR_HOST_IMAGE(access::mode::discard_write)
+SYCL_ADD_ACCESSOR_HOST_IMAGE(access::mode::discard_read_write)
+
+#undef SYCL_ADD_ACCESSOR_HOST_IMAGE
+
+}  // namespace sycl
+}  // namespace cl
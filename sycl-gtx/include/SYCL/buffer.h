@@ -7,14 +7,17 @@
 #include "SYCL/command_group.h"
 #include "SYCL/detail/common.h"
 #include "SYCL/detail/debug.h"
+#include "SYCL/detail/partition.h"
 #include "SYCL/detail/synchronizer.h"
 #include "SYCL/error_handler.h"
 #include "SYCL/event.h"
 #include "SYCL/info.h"
+#include "SYCL/mapped_file.h"
 #include "SYCL/param_traits.h"
 #include "SYCL/ranges.h"
 #include "SYCL/refc.h"
 #include <algorithm>
+#include <cstring>
 
 namespace cl {
 namespace sycl {
@@ -25,6 +28,8 @@ class accessor;
 template <typename, int = 1>
 struct buffer;
 class handler;
+template <typename, int>
+class host_accessor_future;
 class queue;
 
 namespace detail {
@@ -55,6 +60,15 @@ class buffer_detail : public buffer_base {
   bool is_read_only = false;
   bool is_blocking = true;
   bool is_initialized = false;
+  // Storage is managed by the runtime, device memory comes from the pool
+  bool is_pooled = false;
+  bool is_host_modified = false;
+  // Sub-buffers share the memory object of their parent
+  buffer_detail* parent = nullptr;
+  // Offset of a sub-buffer in elements of the parent
+  ::size_t origin = 0;
+  // Written with the host data on destruction
+  string_class final_file;
 
   friend class accessor_base;
   friend class accessor_buffer<DataType_t, dimensions>;
@@ -117,7 +131,8 @@ class buffer_detail : public buffer_base {
       : host_data(ptr_t(new DataType[range.size()])),
         rang(range),
         is_read_only(false),
-        is_blocking(false) {}
+        is_blocking(false),
+        is_pooled(true) {}
 
   /**
    * Create a new buffer with associated memory, using the data in hostData.
@@ -141,10 +156,12 @@ class buffer_detail : public buffer_base {
   buffer_detail(unique_ptr_class<void>&& hostData,
                 const range<dimensions>& bufferRange);
 
-  // TODO(progtx):
   /**
    * Create a new sub-buffer without allocation to have separate accessors
    * later.
+   * The sub-buffer has to be contiguous in the buffer b,
+   * so all dimensions below the last one it spans more than once
+   * have to be whole.
    * @param b is the buffer with the real data.
    * @param baseIndex specifies the origin of the sub-buffer inside the buffer
    * b.
@@ -154,20 +171,37 @@ class buffer_detail : public buffer_base {
                 const range<dimensions>& subRange)
       : rang(subRange),
         is_read_only(b.is_read_only),
-        is_blocking(b.is_blocking) {
-    DataType* start = b.host_data.get();
-
-    if (dimensions == 1) {
-      start += static_cast<::size_t>(baseIndex.get(0));
-    } else if (dimensions == 2) {
-      start += static_cast<::size_t>(baseIndex.get(1)) *
-                   static_cast<::size_t>(rang.get(0)) +
-               static_cast<::size_t>(baseIndex.get(0));
-    } else if (dimensions == 3) {
-      // TODO(progtx):
+        is_blocking(b.is_blocking),
+        parent(&b) {
+    // Dimension 0 is contiguous
+    ::size_t multiplier = 1;
+    bool is_whole = true;
+    for (int i = 0; i < dimensions; ++i) {
+      auto base = static_cast<::size_t>(baseIndex.get(i));
+      auto size = static_cast<::size_t>(subRange.get(i));
+      auto whole = static_cast<::size_t>(b.rang.get(i));
+      if (!is_whole && size != 1) {
+        detail::error::report(error::code::NON_CONTIGUOUS_SUB_BUFFER);
+      }
+      is_whole = is_whole && base == 0 && size == whole;
+      origin += base * multiplier;
+      multiplier *= whole;
     }
+    host_data = ptr_t(b.host_data, b.host_data.get() + origin);
+  }
 
-    host_data = ptr_t(start, [](DataType* ptr) {});
+  /**
+   * Creates a buffer using a mapped file as its host data,
+   * which has to be large enough for the range.
+   * Buffers of read-only mappings are read-only.
+   */
+  buffer_detail(const mapped_file& file, range<dimensions> range)
+      : rang(range),
+        host_data(ptr_t(file.mapping, static_cast<DataType*>(file.get()))),
+        is_read_only(file.get_mode() == mapped_file::mode::read_only) {
+    if (file.size() < get_size()) {
+      detail::error::report(CL_INVALID_BUFFER_SIZE);
+    }
   }
 
   /**
@@ -187,7 +221,13 @@ class buffer_detail : public buffer_base {
   buffer_detail& operator=(buffer_detail&&) = default;  // NOLINT
 
   ~buffer_detail() {
+    synchronizer::submit_deferred(this);
     event::wait_and_throw(events);
+    // Not thrown from the destructor
+    if (!final_file.empty() &&
+        !write_file(final_file, host_data.get(), get_size())) {
+      debug("SYCL_ERROR::", "Cannot write the final data to " + final_file);
+    }
   }
 
   /**
@@ -216,6 +256,32 @@ class buffer_detail : public buffer_base {
  private:
   static void create(queue* q, const vector_class<cl_event>& wait_events,
                      buffer_detail* buffer) {
+    if (buffer->parent != nullptr) {
+      create_sub_buffer(buffer);
+      return;
+    }
+
+    if (buffer->is_pooled) {
+      buffer->device_data = buffer_base::pool_create_buffer(
+          q, CL_MEM_READ_WRITE, buffer->get_size());
+
+      auto shadow = buffer_base::pool_create_host(q, buffer->get_size());
+      if (shadow != nullptr) {
+        if (buffer->is_host_modified) {
+          std::memcpy(shadow.get(), buffer->host_data.get(),
+                      buffer->get_size());
+        }
+        buffer->host_data = ptr_t(shadow, static_cast<DataType*>(shadow.get()));
+        buffer->is_host_pinned = true;
+      }
+
+      // Pooled memory has stale contents
+      if (buffer->is_host_modified) {
+        buffer->enqueue(q, wait_events, &clEnqueueWriteBuffer);
+      }
+      return;
+    }
+
     ::cl_int error_code;
     const cl_mem_flags all_flags =
         ((buffer->host_data == nullptr) ? 0 : CL_MEM_USE_HOST_PTR) |
@@ -226,7 +292,33 @@ class buffer_detail : public buffer_base {
     buffer->device_data.release_one();
   }
 
-  void init() {
+  static void create_sub_buffer(buffer_detail* buffer) {
+    auto parent = buffer->parent;
+    // Commands on the parent can be in other queues
+    event::wait(parent->events);
+
+    // The parent could have replaced its host storage on creation
+    buffer->host_data =
+        ptr_t(parent->host_data, parent->host_data.get() + buffer->origin);
+    buffer->is_host_pinned = parent->is_host_pinned;
+
+    ::cl_int error_code;
+    auto origin_bytes = buffer->origin * data_size<DataType_t>::get();
+    buffer->device_data = buffer_base::cl_create_sub_buffer(
+        parent->device_data.get(), origin_bytes, buffer->get_size(),
+        error_code);
+    detail::error::report(error_code);
+    buffer->device_data.release_one();
+  }
+
+  ::size_t access_range(int n) const final {
+    return n < dimensions ? rang.get(n) : 1;
+  }
+
+  void init() final {
+    if (parent != nullptr) {
+      parent->init();
+    }
     if (!is_initialized) {
       command::group_detail::add_buffer_init(create, __func__, this);
       is_initialized = true;
@@ -242,13 +334,66 @@ class buffer_detail : public buffer_base {
   template <access::mode mode, access::target target>
   using acc_return_t = accessor<DataType_t, dimensions, mode, target>;
 
+  /** Sub-buffer holding the part of the buffer a device works on */
+  buffer<DataType_t, dimensions>* get_slice(partition* part) {
+    auto& slice = part->slices[this];
+    if (slice == nullptr) {
+      id<dimensions> base_index;
+      auto sub_range = rang;
+      static_cast<::size_t&>(base_index[dimensions - 1]) = part->offset;
+      sub_range[dimensions - 1] = part->count;
+      if (part->is_streamed) {
+        slice.reset(create_stream_slice(part->offset, sub_range));
+      } else {
+        slice.reset(new buffer<DataType_t, dimensions>(
+            *(static_cast<cl::sycl::buffer<DataType_t, dimensions>*>(this)),
+            base_index, sub_range));
+      }
+    }
+    return static_cast<buffer<DataType_t, dimensions>*>(slice.get());
+  }
+
+  /** Buffer using the host data of a part, written back to it */
+  buffer<DataType_t, dimensions>* create_stream_slice(
+      ::size_t offset, const range<dimensions>& sub_range) {
+    // The host data has to be current
+    event::wait(events);
+
+    ::size_t row = get_count() / rang.get(dimensions - 1);
+    auto host = host_data.get() + offset * row;
+    if (is_read_only) {
+      return new buffer<DataType_t, dimensions>(
+          const_cast<const DataType*>(host), sub_range);
+    }
+    return new buffer<DataType_t, dimensions>(host, sub_range);
+  }
+
   template <access::mode mode, access::target target>
   acc_return_t<mode, target> get_access_device(handler& cgh) {
     command::group_detail::check_scope();
     if (mode != access::mode::read) {
       check_read_only();
     }
+
+    auto part = partition::current;
+    if (part != nullptr && parent == nullptr && !part->is_slice(this) &&
+        target == access::target::global_buffer) {
+      if (dimensions == part->dimensions &&
+          static_cast<::size_t>(rang.get(dimensions - 1)) == part->total) {
+        return get_slice(part)->template get_access_device<mode, target>(cgh);
+      }
+      // Read-only buffers are copied whole to every device
+      if (mode != access::mode::read) {
+        detail::error::report(error::code::NOT_PARTITIONABLE);
+      }
+    }
+
     init();
+    if (parent != nullptr) {
+      // Host accessors to the parent wait for the sub-buffer
+      command::group_detail::add_buffer_access(
+          buffer_access{parent, mode, target}, __func__);
+    }
     command::group_detail::add_buffer_access(buffer_access{this, mode, target},
                                              __func__);
     return acc_return_t<mode, target>(
@@ -259,6 +404,7 @@ class buffer_detail : public buffer_base {
   acc_return_t<mode, target> get_access_host() {
     if (mode != access::mode::read) {
       check_read_only();
+      is_host_modified = true;
     }
     return acc_return_t<mode, target>(
         *(static_cast<cl::sycl::buffer<DataType_t, dimensions>*>(this)));
@@ -276,6 +422,24 @@ class buffer_detail : public buffer_base {
     return get_access_host<mode, target>();
   }
 
+  /**
+   * Starts reading the buffer back to the host without blocking.
+   * The host accessor is obtained from the returned future.
+   */
+  template <access::mode mode>
+  host_accessor_future<DataType_t, dimensions> get_access_async() {
+    return get_access_async<mode>(detail::empty_range<dimensions>(), rang);
+  }
+  template <access::mode mode>
+  host_accessor_future<DataType_t, dimensions> get_access_async(
+      range<dimensions> offset, range<dimensions> range) {
+    static_assert(mode == access::mode::read,
+                  "Only read host accesses can be asynchronous");
+    return host_accessor_future<DataType_t, dimensions>(
+        *(static_cast<cl::sycl::buffer<DataType_t, dimensions>*>(this)),
+        offset, range);
+  }
+
  private:
   // TODO(progtx):
   void enqueue(queue* q, const vector_class<cl_event>& wait_events,
@@ -285,6 +449,9 @@ class buffer_detail : public buffer_base {
         q, get_size(), host_data.get(), wait_events, evnt, clEnqueueBuffer);
     detail::error::report(error_code);
     events.emplace_back(evnt);
+    if (parent != nullptr) {
+      parent->events.emplace_back(evnt);
+    }
   }
 
  protected:
@@ -299,6 +466,16 @@ class buffer_detail : public buffer_base {
 
   // TODO(progtx): nullptr indicates not to copy back
   void set_final_data(std::nullptr_t) {}
+
+  /**
+   * Writes the host data to the file at path when the buffer is destroyed,
+   * such as the results computed in a copy-on-write mapping.
+   * The path can be the mapped file itself,
+   * which is then replaced once the data is written.
+   */
+  void set_final_data(const string_class& path) {
+    final_file = path;
+  }
 };
 
 }  // namespace detail
@@ -320,7 +497,9 @@ class buffer_detail : public buffer_base {
          const range<dimensions>& subRange)                                \
       : Base(b, baseIndex, subRange) {}                                    \
   buffer(cl_mem mem_object, queue& from_queue, event available_event = {}) \
-      : Base(mem_object, from_queue, available_event) {}
+      : Base(mem_object, from_queue, available_event) {}                  \
+  buffer(const mapped_file& file, range<dimensions> range)                 \
+      : Base(file, range) {}
 #endif
 
 template <typename DataType_t>
@@ -351,6 +530,10 @@ struct buffer<DataType_t, 1> : public detail::buffer_detail<DataType_t, 1> {
       : Base(host_data.data(), host_data.size()) {}
   buffer(const vector_class<DataType>& host_data)
       : Base(host_data.data(), host_data.size()) {}
+
+  /** Creates a buffer with as many elements as fit in the mapped file */
+  explicit buffer(const mapped_file& file)
+      : Base(file, file.size() / sizeof(DataType)) {}
 };
 
 template <typename DataType_t>
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "SYCL/buffer_pool.h"
 #include "SYCL/detail/common.h"
 #include "SYCL/detail/debug.h"
 #include "SYCL/event.h"
@@ -7,13 +8,16 @@
 namespace cl {
 namespace sycl {
 
-// Forward declaration
+// Forward declarations
+class command_graph;
 class queue;
 
 namespace detail {
 
 // Forward declarations
 class issue_command;
+class synchronizer;
+class trace_memo_registry;
 namespace command {
 class group_detail;
 }
@@ -23,14 +27,26 @@ class buffer_base {
   virtual ~buffer_base() = default;
 
  protected:
+  friend class command_group;
   friend class issue_command;
+  friend class ::cl::sycl::command_graph;
   friend class ::cl::sycl::queue;
   friend class command::group_detail;
+  friend class synchronizer;
+  friend class trace_memo_registry;
 
-  detail::refc<cl_mem, clRetainMemObject, clReleaseMemObject> device_data;
+  mem_ref device_data;
   vector_class<event> events;
+  // Host storage is a mapped pinned host shadow
+  bool is_host_pinned = false;
 
   void create_accessor_command();
+  /** Adds the command creating the device data, if it doesn't exist yet */
+  virtual void init() {}
+  /** Elements in dimension n, which device indexing is traced with */
+  virtual ::size_t access_range(int n) const {
+    return 1;
+  }
 
   using clEnqueueBuffer_f = decltype(&clEnqueueWriteBuffer);
   virtual void enqueue(queue* q, const vector_class<cl_event>& wait_events,
@@ -45,11 +61,35 @@ class buffer_base {
   }
   ::cl_int cl_enqueue_buffer(queue* q, ::size_t size, void* host_ptr,
                              const vector_class<cl_event>& wait_events,
-                             cl_event& evnt, clEnqueueBuffer_f clEnqueueBuffer);
+                             cl_event& evnt, clEnqueueBuffer_f clEnqueueBuffer,
+                             bool is_blocking = false);
+
+  /** Transfers the whole image, region being its size in pixels */
+  ::cl_int cl_enqueue_image(queue* q, const ::size_t* region, void* host_ptr,
+                            const vector_class<cl_event>& wait_events,
+                            cl_event& evnt, clEnqueueBuffer_f clEnqueueBuffer);
 
   static cl_mem cl_create_buffer(queue* q, const cl_mem_flags& flags,
                                  ::size_t size, void* host_ptr,
                                  ::cl_int& error_code);
+  static cl_mem cl_create_image(queue* q, const cl_mem_flags& flags,
+                                const cl_image_format& format,
+                                const cl_image_desc& desc,
+                                ::cl_int& error_code);
+  /** Region of size bytes at origin inside the parent memory object */
+  static cl_mem cl_create_sub_buffer(cl_mem parent, ::size_t origin,
+                                     ::size_t size, ::cl_int& error_code);
+  /** Memory object from the buffer pool of the queue context */
+  static mem_ref pool_create_buffer(queue* q, const cl_mem_flags& flags,
+                                    ::size_t size);
+  /** Pinned host shadow, nullptr if the context doesn't use pinned memory */
+  static shared_ptr_class<void> pool_create_host(queue* q, ::size_t size);
+  /**
+   * Replaces the file at path with the data
+   * @return false if the file cannot be written
+   */
+  static bool write_file(const string_class& path, const void* data,
+                         ::size_t size);
 };
 
 }  // namespace detail
@@ -0,0 +1,191 @@
+#pragma once
+
+// Pooled device memory for runtime managed buffers (extension)
+
+#include "SYCL/context.h"
+#include "SYCL/detail/common.h"
+#include "SYCL/refc.h"
+#include <map>
+
+namespace cl {
+namespace sycl {
+
+namespace buffer_pool {
+
+struct stats {
+  /** Number of memory objects created through clCreateBuffer */
+  ::size_t allocations = 0;
+  /** Number of requests served from released memory objects */
+  ::size_t reuses = 0;
+  /** Bytes held by live buffers */
+  ::size_t bytes_in_use = 0;
+  /** Bytes held by the pool for reuse */
+  ::size_t bytes_cached = 0;
+  /** High-water mark of bytes_in_use + bytes_cached */
+  ::size_t peak_bytes = 0;
+};
+
+/** Default limit of bytes the pool keeps for reuse in each context */
+static const ::size_t default_limit = 256 * 1024 * 1024;
+
+/**
+ * Sets how many bytes of released memory objects are kept for reuse.
+ * Memory released above the limit is returned to OpenCL.
+ */
+void set_limit(const context& ctx, ::size_t max_cached_bytes);
+
+/** @return allocation statistics of the context */
+stats get_stats(const context& ctx);
+
+/** Returns all cached memory objects of the context to OpenCL */
+void trim(const context& ctx);
+
+/**
+ * Transfers in the context go through pinned host memory.
+ * Runtime managed buffers get host shadows allocated with
+ * CL_MEM_ALLOC_HOST_PTR, buffers over user memory are staged
+ * through a ring of pinned chunks.
+ * Host shadows replace the host storage on first device use,
+ * so host pointers taken before that are not valid afterwards.
+ */
+void set_pinned_host(const context& ctx, bool enable = true);
+
+/** @return whether transfers in the context use pinned host memory */
+bool is_pinned_host(const context& ctx);
+
+}  // namespace buffer_pool
+
+namespace detail {
+
+using mem_ref = refc<cl_mem, clRetainMemObject, clReleaseMemObject>;
+
+/**
+ * Persistently mapped chunks of pinned host memory, used in turn.
+ * Each transfer is split into chunks, so that the copy between user memory
+ * and a chunk overlaps with DMA transfers of the other chunks.
+ */
+class staging_ring {
+ private:
+  struct chunk {
+    cl_mem mem;
+    void* host_ptr;
+    // The chunk can be reused once this event completes
+    cl_event in_use;
+  };
+
+  vector_class<chunk> chunks;
+  ::size_t next = 0;
+  cl_command_queue map_q;
+  mutex_class m;
+
+  chunk& acquire();
+
+ public:
+  static const ::size_t chunk_size = 4 * 1024 * 1024;
+  static const int num_chunks = 4;
+
+  staging_ring(cl_context ctx, cl_command_queue q);
+  staging_ring(const staging_ring&) = delete;
+  staging_ring& operator=(const staging_ring&) = delete;
+  ~staging_ring();
+
+  /**
+   * Chunks are filled from user memory once wait_events complete,
+   * as the commands waited on can still write the user memory
+   */
+  ::cl_int write(cl_command_queue q, cl_mem mem, bool is_blocking,
+                 ::size_t size, const void* host_ptr,
+                 const vector_class<cl_event>& wait_events, cl_event& evnt);
+  /** A blocking read returns once user memory holds the data */
+  ::cl_int read(cl_command_queue q, cl_mem mem, bool is_blocking,
+                ::size_t size, void* host_ptr,
+                const vector_class<cl_event>& wait_events, cl_event& evnt);
+};
+
+/**
+ * Memory objects of one context kept for reuse.
+ * Context objects of the same OpenCL context share the pool,
+ * memory objects taken from it keep it alive until they are released.
+ */
+class context_pool {
+ private:
+  friend class memory_pool;
+
+  using key_t = std::pair<cl_mem_flags, ::size_t>;
+
+  struct pooled {
+    cl_mem mem;
+    // Pinned host shadows stay mapped while pooled
+    void* host_ptr;
+    cl_command_queue map_q;
+  };
+
+  // Not retained, the context objects sharing the pool
+  // and the pooled memory objects keep the context alive
+  cl_context ctx;
+  std::multimap<key_t, pooled> released;
+  ::size_t limit = buffer_pool::default_limit;
+  buffer_pool::stats s;
+  bool pinned = false;
+  shared_ptr_class<staging_ring> staging;
+  mutex_class m;
+
+  void trim(::size_t max_cached_bytes);
+  void release(key_t key, pooled p);
+  pooled take(key_t key);
+
+ public:
+  explicit context_pool(cl_context ctx) : ctx(ctx) {}
+  context_pool(const context_pool&) = delete;
+  context_pool& operator=(const context_pool&) = delete;
+  ~context_pool();
+};
+
+/**
+ * Recycles memory objects of buffers whose storage is managed by the runtime.
+ * Sizes are rounded up to size classes, so released memory objects
+ * can serve later requests of similar size.
+ */
+class memory_pool {
+ private:
+  // Pools of the live contexts, to share them between context objects
+  static std::map<cl_context, weak_ptr_class<context_pool>> pools;
+  static mutex_class m;
+
+ public:
+  /** @return pool of the context, shared with its other context objects */
+  static shared_ptr_class<context_pool> attach(cl_context ctx);
+
+  /** Smallest size class that can hold size bytes */
+  static ::size_t size_class(::size_t size);
+
+  /**
+   * @return memory object of at least size bytes,
+   * which returns to the pool once the last reference is gone
+   */
+  static mem_ref acquire(const context& ctx, cl_mem_flags flags,
+                         ::size_t size);
+
+  /**
+   * @return mapped pinned host memory of at least size bytes,
+   * which returns to the pool once the last reference is gone
+   */
+  static shared_ptr_class<void> acquire_host(const context& ctx,
+                                             cl_command_queue q, ::size_t size);
+
+  /** @return staging ring of the context, nullptr if not pinned */
+  static shared_ptr_class<staging_ring> get_staging(const context& ctx,
+                                                    cl_command_queue q);
+
+  static void set_pinned(const context& ctx, bool enable);
+  static bool is_pinned(const context& ctx);
+
+  static void set_limit(const context& ctx, ::size_t max_cached_bytes);
+  static buffer_pool::stats get_stats(const context& ctx);
+  static void trim(const context& ctx);
+};
+
+}  // namespace detail
+
+}  // namespace sycl
+}  // namespace cl
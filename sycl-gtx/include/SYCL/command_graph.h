@@ -0,0 +1,83 @@
+#pragma once
+
+// Recorded command groups (extension)
+
+#include "SYCL/buffer.h"
+#include "SYCL/command_group.h"
+#include "SYCL/detail/common.h"
+#include "SYCL/error_handler.h"
+#include <set>
+
+namespace cl {
+namespace sycl {
+
+// Forward declaration
+class queue;
+
+/**
+ * Commands of the command groups submitted to a queue while it was recording,
+ * with their kernels already traced and compiled.
+ * Replaying the graph enqueues all of them as a single command group,
+ * without executing the command group functions again
+ * and without optimizing the commands again.
+ * Values captured by the kernels are part of their source,
+ * only the buffers can be bound again.
+ * The buffers must outlive the graph.
+ */
+class command_graph {
+ private:
+  friend class queue;
+  using command_t = detail::command::info;
+  using buffer_set = std::set<detail::buffer_base*>;
+
+  vector_class<command_t> commands;
+  // Dependencies of the whole graph, used for the wait list of each replay
+  buffer_set read_buffers;
+  buffer_set write_buffers;
+  // Buffers bound after recording, created on the next replay if needed
+  buffer_set bound;
+  ::size_t num_groups = 0;
+
+  void record(const detail::command_group& group);
+  /** Optimizes the transfers across all recorded groups */
+  void plan();
+  /** Adds the recorded commands to the command group in scope */
+  void issue();
+  void rebind(detail::buffer_base* from, detail::buffer_base* to);
+
+ public:
+  command_graph() = default;
+
+  // Kernels are bound to buffers in place, so they cannot be shared
+  command_graph(const command_graph&) = delete;
+  command_graph& operator=(const command_graph&) = delete;
+  command_graph(command_graph&&) = default;
+  command_graph& operator=(command_graph&&) = default;
+
+  /**
+   * Replaces a recorded buffer by another buffer of the same type and size
+   * in all recorded commands
+   */
+  template <typename DataType, int dimensions>
+  void rebind(buffer<DataType, dimensions>& from,
+              buffer<DataType, dimensions>& to) {
+    if (from.get_count() != to.get_count()) {
+      detail::error::report(CL_INVALID_BUFFER_SIZE);
+    }
+    rebind(static_cast<detail::buffer_base*>(&from),
+           static_cast<detail::buffer_base*>(&to));
+  }
+
+  /** @return number of command groups recorded */
+  ::size_t get_num_groups() const {
+    return num_groups;
+  }
+
+  /** @return number of commands enqueued on each replay */
+  ::size_t get_num_commands() const {
+    return commands.size();
+  }
+};
+
+}  // namespace sycl
+}  // namespace cl
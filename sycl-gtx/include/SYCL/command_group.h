@@ -7,12 +7,15 @@
 #include "SYCL/detail/common.h"
 #include "SYCL/detail/debug.h"
 #include "SYCL/ranges.h"
+#include <array>
+#include <map>
 #include <set>
 
 namespace cl {
 namespace sycl {
 
 // Forward declarations
+class command_graph;
 class event;
 class handler;
 class kernel;
@@ -20,17 +23,22 @@ class queue;
 
 namespace detail {
 
-// Forward declarations
+// Forward declaration
 static inline unique_ptr_class<handler> get_handler(queue* q);
-template <typename, int>
-class buffer_detail;
 
 namespace command {
 
 // Forward declaration
 class group_detail;
 
-enum class type_t { unspecified, get_accessor, copy_data, kernel };
+enum class type_t {
+  unspecified,
+  get_accessor,
+  copy_data,
+  kernel,
+  device_op,
+  host_task
+};
 
 static debug& operator<<(debug& d, type_t t) {
   string_class str("command::type::");
@@ -44,6 +52,12 @@ static debug& operator<<(debug& d, type_t t) {
     case type_t::kernel:
       str += "kernel";
       break;
+    case type_t::device_op:
+      str += "device_op";
+      break;
+    case type_t::host_task:
+      str += "host_task";
+      break;
     case type_t::unspecified:
     default:
       str += "unspecified";
@@ -56,6 +70,42 @@ static debug& operator<<(debug& d, type_t t) {
 struct buffer_copy {
   buffer_access buf;
   access::mode mode;
+  // Needed to bind the copy to another buffer
+  decltype(&clEnqueueWriteBuffer) enqueue;
+};
+
+/** Part of a buffer or of host memory, dimension 0 is measured in bytes */
+struct region {
+  std::array<::size_t, 3> origin;
+  std::array<::size_t, 3> size;
+  ::size_t row_pitch;
+  ::size_t slice_pitch;
+
+  /** @return true if the region is a single block of memory */
+  bool is_contiguous() const {
+    return (size[1] == 1 && size[2] == 1) ||
+           (size[0] == row_pitch &&
+            (size[2] == 1 || size[1] * row_pitch == slice_pitch));
+  }
+  /** @return offset of the first byte */
+  ::size_t start() const {
+    return origin[0] + origin[1] * row_pitch + origin[2] * slice_pitch;
+  }
+  ::size_t bytes() const {
+    return size[0] * size[1] * size[2];
+  }
+};
+
+/** Fill or copy executed by the device without a kernel */
+struct device_op {
+  using enqueue_f =
+      function_class<::cl_int(cl_command_queue, cl_mem src, cl_mem dst,
+                              const vector_class<cl_event>&, cl_event*)>;
+
+  // Data is nullptr for fills and for host memory
+  buffer_access src;
+  buffer_access dst;
+  enqueue_f enqueue;
 };
 
 union metadata {
@@ -75,12 +125,31 @@ struct info {
   command_f function;
   type_t type;
   metadata data;
+  // Only for kernels, tells the optimizer which buffers they use
+  shared_ptr_class<kernel> kern;
+  // Only for kernels and device operations, set once they are enqueued
+  shared_ptr_class<event> kernel_event;
+  // Only for device operations
+  shared_ptr_class<device_op> op;
 
   static void do_nothing(queue* q, const vector_class<cl_event>&) {}
 };
 
 }  // namespace command
 
+/**
+ * Range kernel held back until the next command group is known,
+ * so that the two can be fused into one kernel
+ */
+struct deferred_kernel {
+  shared_ptr_class<kernel> kern;
+  // Range and offset, fused kernels need to have the same ones
+  vector_class<::size_t> shape;
+  string_class compile_options;
+  // Compiles the kernel and adds the commands that execute it
+  function_class<void()> issue;
+};
+
 /**
  * A command group in SYCL as it is defined in 2.3.1
  * includes a kernel to be enqueued along with all the commands
@@ -91,6 +160,7 @@ class command_group {
  private:
   friend class kernel;
   friend class command::group_detail;
+  friend class ::cl::sycl::command_graph;
   friend class ::cl::sycl::queue;
   using command_t = command::info;
   using command_f = command_t::command_f;
@@ -99,10 +169,49 @@ class command_group {
   std::set<buffer_base*> read_buffers;
   std::set<buffer_base*> write_buffers;
   queue* q;
+  shared_ptr_class<deferred_kernel> deferred;
+  // Set until the commands are flushed
+  bool is_optimized = false;
 
   void enter();
   void exit();
 
+  /**
+   * Takes over the deferred kernel and the commands of next
+   * if the kernels can be fused
+   */
+  bool fuse(command_group& next);
+  /** Adds the commands of the deferred kernel */
+  void issue_deferred();
+  /** Moves the commands of another group after the ones of this group */
+  void append(command_group& other);
+
+  using buffer_modes = std::map<buffer_base*, access::mode>;
+  static bool get_kernel_buffers(const kernel& kern, buffer_modes& buffers);
+  /**
+   * Buffers used by a kernel or a device operation
+   * @return false if they are not known
+   */
+  static bool get_device_buffers(const command_t& command,
+                                 buffer_modes& buffers);
+
+  /**
+   * Enqueues copies on the transfer queue and the rest on the command queue,
+   * each waiting for the commands in the other queue using the same buffers
+   */
+  void flush_overlapped(const vector_class<cl_event>& wait_events);
+
+  bool has_host_task() const;
+  /**
+   * Runs the task on the thread pool once the commands before it completed.
+   * Later commands in both queues wait for the task,
+   * later groups wait for it through the events of the buffers.
+   */
+  static void enqueue_host_task(queue* q,
+                                const vector_class<cl_event>& wait_events,
+                                function_class<void()> task,
+                                vector_class<buffer_base*> buffers);
+
  public:
   command_group(queue* q) : q(q) {}
 
@@ -141,6 +250,11 @@ class command_group {
   command_group(queue& primaryQueue, queue& secondaryQueue, functorT lambda);
 
   void optimize();
+  /**
+   * Optimizes commands gathered from several groups,
+   * which are executed in order on the same queue
+   */
+  void optimize_window();
   void flush(vector_class<cl_event> wait_events);
 };
 
@@ -157,7 +271,8 @@ class group_detail {
   using fn = void (*)(queue*, const vector_class<cl_event>&, Args...);
 
   template <class... Args>
-  using kern_fn = fn<shared_ptr_class<kernel>, event*, Args...>;
+  using kern_fn =
+      fn<shared_ptr_class<kernel>, shared_ptr_class<event>, Args...>;
 
   template <type_t type = type_t::unspecified, class F, class... Args>
   static void add_command(F function, string_class name, Args... params) {
@@ -167,33 +282,45 @@ class group_detail {
                               type});
   }
 
+  template <class... Args>
+  static void add_kernel_command(kern_fn<Args...> function, string_class name,
+                                 shared_ptr_class<kernel> kern,
+                                 shared_ptr_class<event> evnt,
+                                 Args... params) {
+    add_command<type_t::kernel>(function, name, kern, evnt, params...);
+    last->commands.back().kern = kern;
+    last->commands.back().kernel_event = evnt;
+  }
+
+  /** Adds the operation with the transfers it needs, same as for kernels */
+  static void add_device_op(shared_ptr_class<device_op> op, string_class name);
+
  public:
   static void add_kernel_enqueue_task(kern_fn<> function, string_class name,
                                       shared_ptr_class<kernel> kern,
-                                      event* evnt) {
-    add_command(function, name, kern, evnt);
+                                      shared_ptr_class<event> evnt) {
+    add_kernel_command(function, name, kern, evnt);
   }
 
   template <int dimensions>
   static void add_kernel_enqueue_range(
       kern_fn<range<dimensions>, id<dimensions>> function, string_class name,
-      shared_ptr_class<kernel> kern, event* evnt,
+      shared_ptr_class<kernel> kern, shared_ptr_class<event> evnt,
       range<dimensions> num_work_items, id<dimensions> offset) {
-    add_command(function, name, kern, evnt, num_work_items, offset);
+    add_kernel_command(function, name, kern, evnt, num_work_items, offset);
   }
 
   template <int dimensions>
   static void add_kernel_enqueue_nd_range(
       kern_fn<nd_range<dimensions>> function, string_class name,
-      shared_ptr_class<kernel> kern, event* evnt,
+      shared_ptr_class<kernel> kern, shared_ptr_class<event> evnt,
       nd_range<dimensions> execution_range) {
-    add_command(function, name, kern, evnt, execution_range);
+    add_kernel_command(function, name, kern, evnt, execution_range);
   }
 
-  template <typename DataType, int dimensions>
-  static void add_buffer_init(fn<buffer_detail<DataType, dimensions>*> function,
-                              string_class name,
-                              buffer_detail<DataType, dimensions>* buff) {
+  template <class Buffer>
+  static void add_buffer_init(fn<Buffer*> function, string_class name,
+                              Buffer* buff) {
     add_command(function, name, buff);
   }
 
@@ -205,6 +332,47 @@ class group_detail {
       string_class name, buffer_base* buffer,
       buffer_base::clEnqueueBuffer_f enqueue_function);
 
+  // Device operations keep the host data current like kernels do,
+  // the transfers are dropped by the optimizer where they are not needed
+
+  static void add_fill(buffer_access dst, region dst_region,
+                       vector_class<char> pattern);
+  static void add_copy(buffer_access src, region src_region,
+                       buffer_access dst, region dst_region);
+  static void add_copy_to_host(buffer_access src, region src_region,
+                               void* dst, region dst_region);
+  static void add_copy_from_host(const void* src, region src_region,
+                                 buffer_access dst, region dst_region);
+  /** Reads the buffer back to its host data */
+  static void add_update_host(buffer_access buf_acc);
+
+  /** Host callable depending on the commands added so far */
+  static void add_host_task(function_class<void()> task);
+
+  static void enqueue_device_op(queue* q,
+                                const vector_class<cl_event>& wait_events,
+                                shared_ptr_class<device_op> op,
+                                shared_ptr_class<event> evnt);
+
+  /**
+   * Defers the kernel if the current group has no deferred kernel yet,
+   * otherwise issues the one it has
+   */
+  static bool defer_kernel(deferred_kernel kern);
+  /**
+   * Adds the deferred kernel of the current group,
+   * so that commands added after it keep their order
+   */
+  static void issue_deferred();
+
+  /** Adds commands that were already optimized when they were recorded */
+  static void add_recorded(const vector_class<info>& commands,
+                           const std::set<buffer_base*>& read_buffers,
+                           const std::set<buffer_base*>& write_buffers);
+
+  /** @return device accessors requested so far in the current group */
+  static vector_class<buffer_access> get_accessors();
+
   static bool in_scope();
   static void check_scope();
 
@@ -0,0 +1,82 @@
+#pragma once
+
+// Compile option profiles for generated kernels (extension)
+
+#include "SYCL/detail/common.h"
+#include "SYCL/detail/kernel_name.h"
+#include <map>
+
+namespace cl {
+namespace sycl {
+
+namespace compile_options {
+
+// Commonly used OpenCL compiler flags
+static const char fast_relaxed_math[] = "-cl-fast-relaxed-math";
+static const char mad_enable[] = "-cl-mad-enable";
+static const char denorms_are_zero[] = "-cl-denorms-are-zero";
+static const char unsafe_math_optimizations[] =
+    "-cl-unsafe-math-optimizations";
+static const char no_signed_zeros[] = "-cl-no-signed-zeros";
+static const char finite_math_only[] = "-cl-finite-math-only";
+
+/** Joins compile options, skipping empty ones */
+string_class join(const string_class& first, const string_class& second);
+
+template <class... Others>
+string_class join(const string_class& first, const string_class& second,
+                  const Others&... others) {
+  return join(join(first, second), others...);
+}
+
+/** Profile commonly used for float-heavy kernels */
+string_class fast_math();
+
+}  // namespace compile_options
+
+namespace detail {
+
+/**
+ * Compile options attached to kernel names.
+ * The options of the queue the kernel is submitted to are prepended.
+ */
+class compile_options_registry {
+ private:
+  static std::map<::size_t, string_class> options;
+  static mutex_class m;
+
+ public:
+  static void set(::size_t kernel_name_id, string_class compile_options);
+  static void remove(::size_t kernel_name_id);
+  static string_class get(::size_t kernel_name_id);
+};
+
+}  // namespace detail
+
+namespace compile_options {
+
+/** Attaches compile options to all kernels named KernelName */
+template <typename KernelName>
+void set(string_class options) {
+  detail::compile_options_registry::set(
+      detail::kernel_name::get<KernelName>(), std::move(options));
+}
+
+/** Removes the compile options attached to KernelName */
+template <typename KernelName>
+void reset() {
+  detail::compile_options_registry::remove(
+      detail::kernel_name::get<KernelName>());
+}
+
+/** @return compile options attached to KernelName */
+template <typename KernelName>
+string_class get() {
+  return detail::compile_options_registry::get(
+      detail::kernel_name::get<KernelName>());
+}
+
+}  // namespace compile_options
+
+}  // namespace sycl
+}  // namespace cl
@@ -17,6 +17,10 @@ namespace sycl {
 // Forward declarations
 class platform;
 class program;
+namespace detail {
+class context_pool;
+class memory_pool;
+}  // namespace detail
 
 /**
  * 2.3.1, point 2
@@ -33,7 +37,10 @@ class context {
   detail::refc<cl_context, clRetainContext, clReleaseContext> ctx;
   vector_class<device> target_devices;
   async_handler asyncHandler;
+  // Memory objects kept for reuse, see buffer_pool.h
+  shared_ptr_class<detail::context_pool> pool;
   friend struct detail::error::thrower;
+  friend class detail::memory_pool;
 
   /** Master constructor */
   context(cl_context c, const async_handler& asyncHandler,
@@ -81,12 +88,14 @@ class context {
   context(context&& move)
       : SYCL_MOVE_INIT(ctx),
         SYCL_MOVE_INIT(target_devices),
-        SYCL_MOVE_INIT(asyncHandler) {}
+        SYCL_MOVE_INIT(asyncHandler),
+        SYCL_MOVE_INIT(pool) {}
   friend void swap(context& first, context& second) {
     using std::swap;
     SYCL_SWAP(ctx);
     SYCL_SWAP(target_devices);
     SYCL_SWAP(asyncHandler);
+    SYCL_SWAP(pool);
   }
 #else
   context(context&&) = default;             // NOLINT
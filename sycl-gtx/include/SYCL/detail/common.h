@@ -126,10 +126,18 @@ auto get_cl_array(vector_class<From> array)
 
 template <typename EnumClass, EnumClass Value, class T>
 bool has_extension(T* sycl_class, const string_class& extension_name) {
-  // TODO(progtx): Maybe add caching
-  return false;  // TODO(progtx): Doesn't seem to work, ignore for now
-  // return sycl_class->get_info<Value>().find(extension_name) !=
-  // string_class::npos;
+  auto extensions = sycl_class->template get_info<Value>();
+  // Names are separated by spaces and can be prefixes of other names
+  ::size_t pos = 0;
+  while ((pos = extensions.find(extension_name, pos)) != string_class::npos) {
+    auto end = pos + extension_name.length();
+    if ((pos == 0 || extensions[pos - 1] == ' ') &&
+        (end == extensions.length() || extensions[end] == ' ')) {
+      return true;
+    }
+    pos = end;
+  }
+  return false;
 }
 
 template <typename DataType>
@@ -179,6 +187,20 @@ struct base_host_data {
   using type = DataType;
 };
 
+/** Number of elements of the kernel pointer taken by one buffer element */
+template <typename DataType>
+struct pointer_span {
+  static const ::size_t value = 1;
+};
+
+/** Element type of the kernel pointer to the buffer */
+template <typename DataType>
+struct pointer_type_string {
+  static string_class get() {
+    return type_string<DataType>::get();
+  }
+};
+
 template <typename T>
 struct get_string {
   static string_class get(const T& t) {
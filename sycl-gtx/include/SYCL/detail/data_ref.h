@@ -33,7 +33,7 @@ class data_ref {
 
   static const string_class open_parenthesis;
   string_class name;
-  type_t type;
+  type_t type = type_t::general;
 
   static string_class get_name(const data_ref& dref) {
     return dref.name;
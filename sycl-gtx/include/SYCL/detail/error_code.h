@@ -99,7 +99,11 @@ struct code {
     NOT_IN_COMMAND_GROUP_SCOPE,
     TRYING_TO_WRITE_READ_ONLY_BUFFER,
     BUFFER_NOT_INITIALIZED,
-    NOT_IN_KERNEL_SCOPE
+    NOT_IN_KERNEL_SCOPE,
+    NOT_PARTITIONABLE,
+    NOT_RECORDING,
+    CANNOT_ACCESS_FILE,
+    NON_CONTIGUOUS_SUB_BUFFER
   };
 };
 
@@ -112,6 +116,10 @@ static const std::map<code::value_t, string_class> codes = {
     SYCL_ADD_ERROR(code::TRYING_TO_WRITE_READ_ONLY_BUFFER),
     SYCL_ADD_ERROR(code::BUFFER_NOT_INITIALIZED),
     SYCL_ADD_ERROR(code::NOT_IN_KERNEL_SCOPE),
+    SYCL_ADD_ERROR(code::NOT_PARTITIONABLE),
+    SYCL_ADD_ERROR(code::NOT_RECORDING),
+    SYCL_ADD_ERROR(code::CANNOT_ACCESS_FILE),
+    SYCL_ADD_ERROR(code::NON_CONTIGUOUS_SUB_BUFFER),
 };
 
 }  // namespace error
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "SYCL/detail/common.h"
+#include "SYCL/info.h"
+#include <map>
+#include <set>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+/**
+ * Results of information queries that cannot change,
+ * stored per OpenCL object and parameter.
+ * Filled by the first query, safe to use from multiple threads.
+ * Only meant for objects that live as long as the program,
+ * because handles of released objects can be reused.
+ */
+class info_cache {
+ private:
+  using key_t = std::pair<const void*, cl_uint>;
+
+  static std::map<key_t, vector_class<char>> values;
+  // Devices returned by clGetDeviceIDs
+  static std::set<const void*> roots;
+  static mutex_class m;
+
+ public:
+  /**
+   * Copies the stored value, if there is one that fits into size bytes.
+   * @return false if the value needs to be queried
+   */
+  static bool get(const void* object, cl_uint param, ::size_t size,
+                  void* value, ::size_t* actual_size);
+  static void set(const void* object, cl_uint param, const void* value,
+                  ::size_t size);
+
+  /** Root devices are never released, unlike sub-devices */
+  static void add_root(const void* device);
+  static bool is_root(const void* device);
+};
+
+template <typename EnumClass, EnumClass param>
+struct is_immutable_info : std::false_type {};
+
+// Platforms are never released, devices are only cached if they are roots
+template <typename EnumClass>
+struct is_root_only_info : std::false_type {};
+template <>
+struct is_root_only_info<info::device> : std::true_type {};
+
+template <info::device param>
+struct is_immutable_info<info::device, param>
+    : std::integral_constant<bool, param != info::device::reference_count> {};
+template <info::platform param>
+struct is_immutable_info<info::platform, param> : std::true_type {};
+
+}  // namespace detail
+}  // namespace sycl
+}  // namespace cl
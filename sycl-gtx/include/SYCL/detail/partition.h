@@ -0,0 +1,46 @@
+#pragma once
+
+#include "SYCL/buffer_base.h"
+#include "SYCL/detail/common.h"
+#include "SYCL/event.h"
+#include <map>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+/**
+ * Part of a range that one device of a distributed queue executes,
+ * or one chunk of a streaming queue.
+ * Ranges are split along the last dimension,
+ * so each part of a buffer accessed with the same range is contiguous.
+ */
+struct partition {
+  int dimensions;
+  // Size of the whole range and of this part, along the last dimension
+  ::size_t total;
+  ::size_t offset;
+  ::size_t count;
+  // Slices are buffers of their own instead of sub-buffers,
+  // so only the part is allocated on the device
+  bool is_streamed;
+  // Sub-buffers standing in for the buffers accessed by the kernel
+  std::map<buffer_base*, shared_ptr_class<buffer_base>> slices;
+  shared_ptr_class<event> kernel_event;
+
+  // Set while the command group function of a part is being executed
+  SYCL_THREAD_LOCAL static partition* current;
+
+  bool is_slice(buffer_base* buf) const {
+    for (auto& slice : slices) {
+      if (slice.second.get() == buf) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+}  // namespace detail
+}  // namespace sycl
+}  // namespace cl
@@ -20,38 +20,56 @@ class issue_command {
                               kernel_ns::source src,
                               shared_ptr_class<kernel> kern);
   static void prepare_kernel(shared_ptr_class<kernel> kern);
+  /**
+   * Shared virtual memory has no copies to wait on,
+   * so its users wait on the kernel itself
+   */
+  static void add_svm_events(shared_ptr_class<kernel> kern,
+                             shared_ptr_class<event> evnt);
 
   static void enqueue_task_command(queue* q,
                                    const vector_class<cl_event>& wait_events,
-                                   shared_ptr_class<kernel> kern, event* evnt);
+                                   shared_ptr_class<kernel> kern,
+                                   shared_ptr_class<event> evnt);
 
   template <int dimensions>
   static void enqueue_range_command(queue* q,
                                     const vector_class<cl_event>& wait_events,
-                                    shared_ptr_class<kernel> kern, event* evnt,
+                                    shared_ptr_class<kernel> kern,
+                                    shared_ptr_class<event> evnt,
                                     range<dimensions> num_work_items,
                                     id<dimensions> offset) {
     prepare_kernel(kern);
-    kern->enqueue_range(q, wait_events, evnt, num_work_items, offset);
+    kern->enqueue_range(q, wait_events, evnt.get(), num_work_items, offset);
+    add_svm_events(kern, evnt);
   }
 
   template <int dimensions>
   static void enqueue_nd_range_command(
       queue* q, const vector_class<cl_event>& wait_events,
-      shared_ptr_class<kernel> kern, event* evnt,
+      shared_ptr_class<kernel> kern, shared_ptr_class<event> evnt,
       nd_range<dimensions> execution_range) {
     prepare_kernel(kern);
-    kern->enqueue_nd_range(q, wait_events, evnt, execution_range);
+    kern->enqueue_nd_range(q, wait_events, evnt.get(), execution_range);
+    add_svm_events(kern, evnt);
   }
 
  public:
+  /**
+   * Shared virtual memory declared in the command group
+   * that the kernel doesn't take as an argument,
+   * it may reach it through pointers stored in other allocations
+   */
+  static void declare_svm(shared_ptr_class<kernel> kern);
   static void write_buffers_to_device(shared_ptr_class<kernel> kern);
   static void read_buffers_from_device(shared_ptr_class<kernel> kern);
 
-  static void enqueue_task(shared_ptr_class<kernel> kern, event* evnt);
+  static void enqueue_task(shared_ptr_class<kernel> kern,
+                           shared_ptr_class<event> evnt);
 
   template <int dimensions>
-  static void enqueue_range(shared_ptr_class<kernel> kern, event* evnt,
+  static void enqueue_range(shared_ptr_class<kernel> kern,
+                            shared_ptr_class<event> evnt,
                             range<dimensions> num_work_items,
                             id<dimensions> offset) {
     command::group_detail::add_kernel_enqueue_range(
@@ -59,7 +77,8 @@ class issue_command {
   }
 
   template <int dimensions>
-  static void enqueue_nd_range(shared_ptr_class<kernel> kern, event* evnt,
+  static void enqueue_nd_range(shared_ptr_class<kernel> kern,
+                               shared_ptr_class<event> evnt,
                                nd_range<dimensions> execution_range) {
     command::group_detail::add_kernel_enqueue_nd_range(
         enqueue_nd_range_command, __func__, kern, evnt, execution_range);
@@ -3,8 +3,9 @@
 #include "SYCL/accessors/buffer.h"
 #include "SYCL/command_group.h"
 #include "SYCL/detail/common.h"
-#include "SYCL/detail/counter.h"
 #include "SYCL/detail/debug.h"
+#include "SYCL/detail/partition.h"
+#include "SYCL/sampler.h"
 #include <map>
 
 namespace cl {
@@ -26,23 +27,32 @@ namespace kernel_ns {
 template <class Input>
 struct constructor;
 
-class source : protected counter<source> {
+class source {
  private:
   struct buf_info {
     buffer_access acc;
     string_class resource_name;
     string_class type_name;
     ::size_t size;
+    // Subtracted from the pointer, so global indices work on sub-buffers
+    string_class rebase;
   };
 
   static const string_class resource_name_root;
-  SYCL_THREAD_LOCAL static int num_resources;
 
   string_class tab_offset;
 
   string_class kernel_name;
   vector_class<string_class> lines;
   std::map<void*, buf_info> resources;
+  // Keys of the resources in the order of the kernel parameters
+  vector_class<void*> arguments;
+  // Sampler constants declared before the kernel, by name
+  std::map<string_class, string_class> samplers;
+  // Shared virtual memory the kernel reaches through stored pointers
+  vector_class<buffer_base*> svm_allocations;
+  // Each fused body is kept in its own block
+  bool is_fused = false;
 
   // TODO(progtx): Multithreading support
   SYCL_THREAD_LOCAL static source* scope;
@@ -52,15 +62,21 @@ class source : protected counter<source> {
   friend class ::cl::sycl::detail::issue_command;
 
   string_class generate_accessor_list() const;
+  /** Whether the kernel computes with or stores half values */
+  bool uses_half() const;
+  string_class generate_declarations() const;
+  string_class generate_body() const;
+  void generate_name();
+
+  static bool is_fusable(const buf_info& info);
+  static bool is_elementwise(const vector_class<string_class>& lines,
+                             const string_class& resource_name);
 
   static void enter(source& src);
   static source exit(source& src);
 
  public:
-  source()
-      : tab_offset("\t"),
-        kernel_name(string_class("_sycl_kernel_") +
-                    get_string<counter_t>::get(get_count_id())) {}
+  source() : tab_offset("\t") {}
 
   static bool in_scope();
 
@@ -69,6 +85,26 @@ class source : protected counter<source> {
 
   void init_kernel(program& p, shared_ptr_class<kernel> kern);
 
+  /**
+   * Checks if next can be appended to this kernel,
+   * both executing over the same range.
+   * Buffers that either kernel writes and both use
+   * must only be accessed at the id of the work item.
+   */
+  bool can_fuse(const source& next) const;
+  /** Appends the body of next, with its resources renamed to this kernel */
+  void fuse(const source& next);
+
+  /** @return buffers accessed by the kernel, with their access modes */
+  std::map<buffer_base*, access::mode> get_buffer_modes() const;
+  /** @return buffers in the order of the kernel parameters */
+  vector_class<buffer_base*> get_buffers() const;
+  /**
+   * Binds the kernel to other buffers of the same types,
+   * given in the order of the kernel parameters
+   */
+  void rebind(const vector_class<buffer_base*>& buffers);
+
   template <typename DataType, int dimensions, access::mode mode,
             access::target target>
   static string_class register_resource(
@@ -83,12 +119,15 @@ class source : protected counter<source> {
     auto it = scope->resources.find(buf);
 
     if (it == scope->resources.end()) {
-      resource_name = resource_name_root +
-                      get_string<decltype(num_resources)>::get(++num_resources);
+      resource_name =
+          resource_name_root +
+          get_string<::size_t>::get(scope->arguments.size() + 1);
       scope->resources[buf] = {{buf, mode, target},
                                resource_name,
-                               type_string<DataType>::get() + '*',
-                               acc.argument_size()};
+                               pointer_type_string<DataType>::get() + '*',
+                               acc.argument_size(),
+                               get_rebase(buf)};
+      scope->arguments.push_back(buf);
     } else {
       resource_name = it->second.resource_name;
     }
@@ -96,6 +135,62 @@ class source : protected counter<source> {
     return resource_name;
   }
 
+  /** Images are passed as image objects, never rebased */
+  template <typename DataType, int dimensions, access::mode mode>
+  static string_class register_resource(
+      const accessor_core<DataType, dimensions, mode, access::target::image>&
+          acc) {
+    if (scope == nullptr) {
+      return "";
+    }
+
+    auto key = acc.resource();
+    auto it = scope->resources.find(key);
+    if (it != scope->resources.end()) {
+      return it->second.resource_name;
+    }
+
+    auto resource_name = resource_name_root +
+                         get_string<::size_t>::get(scope->arguments.size() + 1);
+    scope->resources[key] = {
+        {static_cast<buffer_base*>(key), mode, access::target::image},
+        resource_name,
+        "image" + get_string<int>::get(dimensions) + "d_t",
+        acc.argument_size(),
+        ""};
+    scope->arguments.push_back(key);
+    return resource_name;
+  }
+
+  /** @return name of the sampler constant */
+  static string_class register_sampler(const sampler& smpl);
+
+  /** Shared virtual memory is passed as a plain pointer, never rebased */
+  static string_class register_svm(buffer_base* svm, access::mode mode,
+                                   const string_class& type_name);
+
+  /** Offset of a partition sub-buffer, in elements of the kernel pointer */
+  template <typename DataType, int dimensions>
+  static string_class get_rebase(buffer<DataType, dimensions>* buf) {
+    auto part = partition::current;
+    if (part == nullptr || !part->is_slice(buf)) {
+      return "";
+    }
+
+    // Partitions span whole rows of the last dimension
+    ::size_t row = pointer_span<DataType>::value;
+    auto rang = buf->get_range();
+    for (int i = 0; i < dimensions - 1; ++i) {
+      row *= rang.get(i);
+    }
+    auto rebase =
+        "get_global_offset(" + get_string<int>::get(dimensions - 1) + ')';
+    if (row != 1) {
+      rebase += " * " + get_string<::size_t>::get(row);
+    }
+    return rebase;
+  }
+
   template <bool auto_end = true>
   static void add(string_class line) {
     scope->lines.push_back(scope->tab_offset + line + (auto_end ? ';' : ' '));
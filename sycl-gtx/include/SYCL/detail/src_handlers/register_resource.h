@@ -2,14 +2,25 @@
 
 namespace cl {
 namespace sycl {
+
+// Forward declaration
+class sampler;
+
 namespace detail {
-namespace kernel_ns {
 
 // Forward declaration
+class buffer_base;
+
+namespace kernel_ns {
+
+// Forward declarations
 template <typename DataType, int dimensions, access::mode mode,
           access::target target>
 static string_class register_resource(
     const accessor_core<DataType, dimensions, mode, target>& acc);
+string_class register_sampler(const sampler& smpl);
+string_class register_svm(buffer_base* svm, access::mode mode,
+                          const string_class& type_name);
 
 }  // namespace kernel_ns
 }  // namespace detail
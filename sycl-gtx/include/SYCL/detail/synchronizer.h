@@ -1,6 +1,7 @@
 #pragma once
 
 #include "SYCL/detail/common.h"
+#include "SYCL/event.h"
 #include <map>
 #include <set>
 
@@ -20,6 +21,8 @@ class synchronizer {
  private:
   static std::set<queue*> queues;
   static std::map<accessor_base*, buffer_base*> host_accessors;
+  // Buffers whose host data is current for the next host accessor
+  static std::set<buffer_base*> synchronized;
 
   static void wait_on_queues(buffer_base* buf);
   static void flush_queues(buffer_base* buf);
@@ -30,6 +33,20 @@ class synchronizer {
   static void add(accessor_base* acc, buffer_base* buf);
   static void remove(accessor_base* acc, buffer_base* buf);
 
+  /**
+   * Flushes the commands using the buffer
+   * @return events the host data of the buffer depends on
+   */
+  static vector_class<event> request(buffer_base* buf);
+  /**
+   * Waits only on the events of the buffer instead of the queues using it,
+   * so that the next host accessor to it does not block
+   */
+  static void synchronize(buffer_base* buf);
+
+  /** Submits commands held back by queues before the buffer is released */
+  static void submit_deferred(buffer_base* buf);
+
   static bool can_flush(const std::set<detail::buffer_base*>& buffers_in_use);
 };
 
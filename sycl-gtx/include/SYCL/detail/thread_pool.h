@@ -0,0 +1,39 @@
+#pragma once
+
+#include "SYCL/detail/common.h"
+#include <condition_variable>
+#include <queue>
+#include <thread>
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+/** Worker threads executing host tasks */
+class thread_pool {
+ private:
+  vector_class<std::thread> workers;
+  std::queue<function_class<void()>> tasks;
+  mutex_class lock;
+  std::condition_variable available;
+  bool is_stopping = false;
+
+  void work();
+
+ public:
+  explicit thread_pool(::size_t num_threads);
+  /** Executes the remaining tasks before joining the threads */
+  ~thread_pool();
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  void push(function_class<void()> task);
+
+  /** Pool shared by all queues, with one thread per core */
+  static thread_pool& get();
+};
+
+}  // namespace detail
+}  // namespace sycl
+}  // namespace cl
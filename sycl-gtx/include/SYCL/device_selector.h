@@ -24,7 +24,8 @@ class device_selector {
   friend class context;
   friend class queue;
 
-  static platform get_platform();
+  /** Platform of the device with the highest score */
+  platform get_platform() const;
   device select_device(vector_class<device> devices) const;
 
   const info::device_type type;
@@ -37,7 +38,14 @@ class device_selector {
   virtual ~device_selector() = default;
 };
 
-// TODO(progtx): Built-in device selectors
+namespace detail {
+/**
+ * Heuristic performance score of a device, negative if it cannot be used.
+ * Considers the device type, compute units, clock frequency,
+ * global and local memory, and the OpenCL version.
+ */
+int device_score(const device& dev);
+}  // namespace detail
 
 /**
  * Devices selected by heuristics of the system.
@@ -45,7 +53,7 @@ class device_selector {
  * Mode.
  */
 struct default_selector : device_selector {
-  default_selector() : device_selector(info::device_type::defaults) {}
+  default_selector() : device_selector(info::device_type::all) {}
   int operator()(const device& dev) const final;
 };
 
@@ -69,6 +77,17 @@ struct cpu_selector : device_selector {
   int operator()(const device& dev) const final;
 };
 
+/**
+ * Ranks devices by the throughput of a short calibration kernel.
+ * Each device is measured once, the ranking is kept for the whole program.
+ * Devices that cannot run the kernel fall back to the heuristic score,
+ * always ranked below measured devices.
+ */
+struct benchmark_selector : device_selector {
+  benchmark_selector() : device_selector(info::device_type::all) {}
+  int operator()(const device& dev) const final;
+};
+
 /** Selects the SYCL host CPU device that does not require an OpenCL runtime. */
 struct host_selector : device_selector {
   host_selector() : device_selector(info::device_type::defaults) {}
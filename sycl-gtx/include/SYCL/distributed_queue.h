@@ -0,0 +1,118 @@
+#pragma once
+
+// Extension: parallel_for distributed across the devices of a context
+
+#include "SYCL/context.h"
+#include "SYCL/detail/common.h"
+#include "SYCL/detail/partition.h"
+#include "SYCL/device.h"
+#include "SYCL/error_handler.h"
+#include "SYCL/queue.h"
+#include "SYCL/ranges.h"
+
+namespace cl {
+namespace sycl {
+
+/**
+ * Executes range based kernels on all devices of a context.
+ * The range is split only along the last dimension,
+ * which varies slowest in buffer storage,
+ * in proportion to the throughput measured on previous submissions.
+ * Each device works on sub-buffers of the buffers accessed with that range,
+ * which are contiguous, and the parts are written back into the same host
+ * storage.
+ * Buffers that are only read and do not match the range
+ * are not partitioned, but copied whole to every device.
+ */
+class distributed_queue {
+ private:
+  struct device_queue {
+    queue q;
+    // Work items per second, relative to the other devices until measured
+    double throughput;
+    bool is_measured;
+    detail::partition part;
+
+    device_queue(const context& syclContext, const device& syclDevice,
+                 const async_handler& asyncHandler);
+  };
+
+  // Weight of the latest measurement
+  static const double smoothing;
+
+  // Queues register themselves with the synchronizer, so they cannot move
+  vector_class<unique_ptr_class<device_queue>> devices;
+  // Partition offsets are multiples of this,
+  // so that sub-buffers are aligned for every device
+  ::size_t granularity = 1;
+
+  vector_class<::size_t> split(::size_t total) const;
+
+ public:
+  /** Creates a profiling queue for each device in the context */
+  explicit distributed_queue(
+      const context& syclContext = context(),
+      const async_handler& asyncHandler = detail::default_async_handler);
+
+  distributed_queue(const distributed_queue&) = delete;
+  distributed_queue& operator=(const distributed_queue&) = delete;
+
+  /**
+   * Submits the command group function once for each device
+   * that gets a non-empty part of numWorkItems.
+   * Kernels must be range based parallel_for calls over numWorkItems.
+   * Buffers written by them must have the same last dimension as the range,
+   * other buffers are copied whole to every device.
+   * The previous submission is waited for first,
+   * so that its parts can move to other devices.
+   */
+  template <int dimensions, typename T>
+  void submit(range<dimensions> numWorkItems, T cgf) {
+    wait();
+    rebalance();
+
+    auto total = numWorkItems[dimensions - 1];
+    auto counts = split(total);
+    ::size_t offset = 0;
+
+    for (::size_t i = 0; i < devices.size(); ++i) {
+      auto& d = *devices[i];
+      // Releases the sub-buffers of the previous submission
+      d.part = {dimensions, total, offset, counts[i]};
+      offset += counts[i];
+      if (counts[i] == 0) {
+        continue;
+      }
+
+      detail::partition::current = &d.part;
+      try {
+        d.q.submit(cgf);
+      } catch (...) {
+        detail::partition::current = nullptr;
+        throw;
+      }
+      detail::partition::current = nullptr;
+    }
+  }
+
+  /**
+   * Updates the throughput of each device
+   * from the profiling information of its last finished kernel.
+   * Called on each submission.
+   */
+  void rebalance();
+
+  void wait();
+  void wait_and_throw();
+
+  vector_class<device> get_devices() const;
+
+  /**
+   * @return share of the range each device gets before alignment,
+   * in the same order as get_devices
+   */
+  vector_class<double> get_shares() const;
+};
+
+}  // namespace sycl
+}  // namespace cl
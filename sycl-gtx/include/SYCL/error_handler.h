@@ -52,6 +52,8 @@ struct thrower {
     throw error;
   }
   static void report_async(context* thrower, exception_list& list);
+  /** Adds the exception being handled to the list */
+  static void add_async(exception_list& list, string_class description);
 };
 
 /** Synchronous error reporting */
@@ -69,6 +71,17 @@ static void report(code::value_t error_code, context* thrower = nullptr) {
 }
 
 }  // namespace error
+
+/**
+ * Asynchronous errors of a queue and its subqueues,
+ * added by the threads running host tasks
+ * until the next wait_and_throw or throw_asynchronous reports them.
+ */
+struct async_error_list {
+  mutex_class lock;
+  exception_list list;
+};
+
 }  // namespace detail
 
 }  // namespace sycl
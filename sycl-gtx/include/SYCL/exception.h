@@ -63,6 +63,17 @@ struct cl_exception : exception {
 
 struct async_exception : exception {
   // stored in an exception_list for asynchronous errors
+ private:
+  friend struct detail::error::thrower;
+
+  /** Holds the error so that it can be rethrown with std::rethrow_exception */
+  async_exception(exception_ptr error, string_class description)
+      : exception(description) {
+    exception_ptr::operator=(error);
+  }
+
+ public:
+  async_exception() = default;
 };
 
 using exception_ptr = std::exception_ptr;
@@ -70,6 +81,7 @@ using exception_ptr = std::exception_ptr;
 // TODO(progtx): Used as a container for a list of asynchronous exceptions
 class exception_list {
  private:
+  friend struct detail::error::thrower;
   using list_t = vector_class<async_exception>;
   list_t list;
 
@@ -0,0 +1,51 @@
+#pragma once
+
+// Batching of submitted command groups (extension)
+
+#include "SYCL/detail/common.h"
+#include <chrono>
+
+namespace cl {
+namespace sycl {
+
+/**
+ * Tells a queue when to hand the command groups it gathered to the device.
+ * Groups are flushed as soon as either limit is reached,
+ * and always on wait, on host access to one of their buffers
+ * and when one of their buffers is destroyed.
+ */
+struct flush_policy {
+  using microseconds = std::chrono::microseconds;
+
+  // Number of gathered groups, 0 for no limit
+  ::size_t groups;
+  // Time since the first gathered group, 0 for no limit.
+  // It is checked on submission.
+  microseconds interval;
+
+  /** Flushes each group on submission, the default */
+  static flush_policy every_group() {
+    return {1, microseconds(0)};
+  }
+
+  /** Flushes once the given number of groups was submitted */
+  static flush_policy every(::size_t groups) {
+    return {groups == 0 ? 1 : groups, microseconds(0)};
+  }
+
+  /** Flushes the first submission after the interval has passed */
+  static flush_policy every(microseconds interval) {
+    if (interval.count() <= 0) {
+      return every_group();
+    }
+    return {0, interval};
+  }
+
+  /** Only flushes when the host needs the results */
+  static flush_policy on_synchronization() {
+    return {0, microseconds(0)};
+  }
+};
+
+}  // namespace sycl
+}  // namespace cl
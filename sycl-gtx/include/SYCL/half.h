@@ -0,0 +1,66 @@
+#pragma once
+
+// 3.10.1 Half precision floating point type
+
+#include "SYCL/detail/common.h"
+
+namespace cl {
+namespace sycl {
+
+/**
+ * 16-bit floating point value, in the layout of cl_half.
+ * On the host, values are converted to float for arithmetic,
+ * so half only saves memory and transfer time.
+ * Conversions from float round to the nearest even value.
+ */
+class half {
+ private:
+  ::cl_half bits;
+
+  static ::cl_half from_float(float value);
+  static float to_float(::cl_half bits);
+
+ public:
+  half() = default;
+  half(float value) : bits(from_float(value)) {}
+
+  operator float() const {
+    return to_float(bits);
+  }
+
+  /** Creates the value with the given binary representation */
+  static half from_bits(::cl_half bits) {
+    half h;
+    h.bits = bits;
+    return h;
+  }
+
+  ::cl_half get_bits() const {
+    return bits;
+  }
+};
+
+namespace detail {
+
+/**
+ * Arithmetic type of half values in kernels,
+ * defined as half or float depending on device support
+ */
+template <>
+struct type_string<half> {
+  static string_class get() {
+    return "_sycl_half";
+  }
+};
+
+template <>
+struct get_string<half> {
+  static string_class get(half value) {
+    return get_string<float>::get(value);
+  }
+};
+
+}  // namespace detail
+
+}  // namespace sycl
+}  // namespace cl
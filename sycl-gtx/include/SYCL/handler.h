@@ -3,12 +3,17 @@
 // 3.5.3 SYCL functions for invoking kernels
 
 #include "SYCL/access.h"
+#include "SYCL/accessors/buffer_base.h"
+#include "SYCL/command_group.h"
+#include "SYCL/compile_options.h"
 #include "SYCL/detail/common.h"
 #include "SYCL/detail/function_traits.h"
+#include "SYCL/detail/partition.h"
 #include "SYCL/detail/src_handlers/issue_command.h"
 #include "SYCL/handler_event.h"
 #include "SYCL/program.h"
 #include "SYCL/ranges.h"
+#include "SYCL/trace_memo.h"
 
 namespace cl {
 namespace sycl {
@@ -29,40 +34,143 @@ class handler {
   friend unique_ptr_class<handler> detail::get_handler(queue* q);
 
   queue* q;
-  handler_event events;
 
   // TODO(progtx): Implementation defined constructor
   handler(queue* q) : q(q) {}
 
   static context get_context(queue* q);
+  static string_class get_compile_options(queue* q);
+  static bool is_kernel_fusion(queue* q);
 
-  template <class KernelType>
+  template <typename KernelName, class KernelType>
   shared_ptr_class<kernel> build(KernelType kernFunctor) {
     detail::command::group_detail::check_scope();
-    program prog(get_context(q));
-    prog.build(kernFunctor, "");
-
-    // We know here the program only contains one kernel
-    return prog.kernels.begin()->second;
+    auto ctx = get_context(q);
+    auto options = compile_options::join(get_compile_options(q),
+                                         compile_options::get<KernelName>());
+    auto build_kernel = [&]() {
+      program prog(ctx);
+      prog.build(kernFunctor, options);
+
+      // We know here the program only contains one kernel
+      return prog.kernels.begin()->second;
+    };
+
+    if (trace_memo::is_enabled<KernelName>()) {
+      return detail::trace_memo_registry::get(
+          detail::kernel_name::get<KernelType>(), ctx.get(), options,
+          build_kernel);
+    }
+    return build_kernel();
   }
 
   using issue = detail::issue_command;
 
   template <class... Args>
-  void issue_enqueue(shared_ptr_class<kernel> kern,
-                     void (*issue_enqueue_f)(shared_ptr_class<kernel>, event*,
-                                             Args...),
-                     Args... params) {
+  static void issue_enqueue(
+      shared_ptr_class<kernel> kern,
+      void (*issue_enqueue_f)(shared_ptr_class<kernel>,
+                              shared_ptr_class<event>, Args...),
+      Args... params) {
+    // Kernels of the group traced before this one run before it
+    detail::command::group_detail::issue_deferred();
+
+    // The event is set when the command group is flushed
+    auto kernel_event = std::make_shared<event>();
+    auto part = detail::partition::current;
+    if (part != nullptr) {
+      part->kernel_event = kernel_event;
+    }
+
+    issue::declare_svm(kern);
     issue::write_buffers_to_device(kern);
-    issue_enqueue_f(kern, &events.kernelEvent, params...);
+    issue_enqueue_f(kern, kernel_event, params...);
     issue::read_buffers_from_device(kern);
   }
 
+  /** Devices of a distributed queue only execute their part of the range */
+  template <int dimensions>
+  static void partition_range(range<dimensions>& numWorkItems,
+                              id<dimensions>& workItemOffset) {
+    auto part = detail::partition::current;
+    if (part == nullptr) {
+      return;
+    }
+    auto& offset = static_cast<::size_t&>(workItemOffset[dimensions - 1]);
+    if (part->dimensions != dimensions ||
+        static_cast<::size_t>(numWorkItems[dimensions - 1]) != part->total ||
+        offset != 0) {
+      detail::error::report(detail::error::code::NOT_PARTITIONABLE);
+    }
+    numWorkItems[dimensions - 1] = part->count;
+    offset = part->offset;
+  }
+
+  /** Whether the command group uses shared virtual memory */
+  static bool uses_svm() {
+    for (auto& acc : detail::command::group_detail::get_accessors()) {
+      if (acc.target == access::target::svm) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static void check_not_partitioned() {
+    if (detail::partition::current != nullptr) {
+      detail::error::report(detail::error::code::NOT_PARTITIONABLE);
+    }
+  }
+
+  /**
+   * With kernel fusion enabled, range kernels are only traced here.
+   * They are compiled once the queue knows
+   * if they can be fused with the next command group.
+   * Kernels with memoized traces or using shared virtual memory
+   * are not deferred.
+   */
+  template <typename KernelName, class KernelType, int dimensions>
+  bool defer(range<dimensions> numWorkItems, id<dimensions> workItemOffset,
+             KernelType kernFunctor) {
+    detail::command::group_detail::check_scope();
+    if (detail::partition::current != nullptr || !is_kernel_fusion(q) ||
+        trace_memo::is_enabled<KernelName>() || uses_svm()) {
+      return false;
+    }
+
+    vector_class<::size_t> shape;
+    for (int i = 0; i < dimensions; ++i) {
+      shape.push_back(static_cast<::size_t>(numWorkItems[i]));
+    }
+    for (int i = 0; i < dimensions; ++i) {
+      shape.push_back(static_cast<::size_t>(workItemOffset[i]));
+    }
+
+    auto ctx = get_context(q);
+    auto options = compile_options::join(get_compile_options(q),
+                                         compile_options::get<KernelName>());
+    auto name_id = detail::kernel_name::get<KernelType>();
+    auto kern = program::trace(kernFunctor);
+
+    return detail::command::group_detail::defer_kernel(
+        {kern, std::move(shape), options, [=]() {
+           program prog(ctx);
+           prog.compile(options, name_id, kern);
+           prog.link();
+           issue_enqueue(kern, &issue::enqueue_range, numWorkItems,
+                         workItemOffset);
+         }});
+  }
+
   template <typename KernelName, class KernelType, int dimensions>
   void parallel_for_range(range<dimensions> numWorkItems,
                           id<dimensions> workItemOffset,
                           KernelType kernFunctor) {
-    auto kern = build(kernFunctor);
+    partition_range(numWorkItems, workItemOffset);
+    if (defer<KernelName>(numWorkItems, workItemOffset, kernFunctor)) {
+      return;
+    }
+    auto kern = build<KernelName>(kernFunctor);
     issue_enqueue(kern, &issue::enqueue_range, numWorkItems, workItemOffset);
   }
   // TODO(progtx): Why is the offset needed? It's already contained in the
@@ -71,10 +179,58 @@ class handler {
   void parallel_for_nd_range(nd_range<dimensions> executionRange,
                              id<dimensions> workItemOffset,
                              KernelType kernFunctor) {
-    auto kern = build(kernFunctor);
+    check_not_partitioned();
+    auto kern = build<KernelName>(kernFunctor);
     issue_enqueue(kern, &issue::enqueue_nd_range, executionRange);
   }
 
+  template <typename DataType, int dimensions, access::mode mode>
+  using buffer_acc_t =
+      accessor<DataType, dimensions, mode, access::target::global_buffer>;
+  using group = detail::command::group_detail;
+
+  template <typename DataType, int dimensions, access::mode mode>
+  static detail::buffer_access get_buffer_access(
+      const buffer_acc_t<DataType, dimensions, mode>& acc) {
+    auto& acc_buf =
+        static_cast<const detail::accessor_buffer<DataType, dimensions>&>(acc);
+    return {acc_buf.buf, mode, access::target::global_buffer};
+  }
+
+  /** Part of the buffer the accessor can reach */
+  template <typename DataType, int dimensions>
+  static detail::command::region get_region(
+      const detail::accessor_buffer<DataType, dimensions>& acc) {
+    auto element = detail::data_size<DataType>::get();
+    auto buffer_range = acc.buf->get_range();
+    detail::command::region r;
+    r.origin = {{0, 0, 0}};
+    r.size = {{1, 1, 1}};
+    for (int i = 0; i < dimensions; ++i) {
+      r.origin[i] = acc.offset.get(i);
+      r.size[i] = acc.rang.get(i);
+    }
+    r.origin[0] *= element;
+    r.size[0] *= element;
+    r.row_pitch = buffer_range.get(0) * element;
+    r.slice_pitch = r.row_pitch;
+    if (dimensions > 1) {
+      r.slice_pitch *= buffer_range.get(1);
+    }
+    return r;
+  }
+
+  /** Host memory holding exactly the part of the buffer in region */
+  static detail::command::region get_host_region(
+      const detail::command::region& buffer_region) {
+    detail::command::region r;
+    r.origin = {{0, 0, 0}};
+    r.size = buffer_region.size;
+    r.row_pitch = r.size[0];
+    r.slice_pitch = r.size[0] * r.size[1];
+    return r;
+  }
+
  public:
   // TODO(progtx):
   template <typename DataType, int dimensions, access::mode mode,
@@ -88,7 +244,8 @@ class handler {
   /** 3.5.3.1 Single Task invoke */
   template <typename KernelName, class KernelType>
   void single_task(KernelType kernFunctor) {
-    auto kern = build(kernFunctor);
+    check_not_partitioned();
+    auto kern = build<KernelName>(kernFunctor);
     issue_enqueue(kern, &issue::enqueue_task);
   }
 
@@ -188,22 +345,110 @@ class handler {
                                         kernFunctor);
   }
 
+  // Data movement executed by the device, without compiling a kernel
+
+  /** Sets each element the accessor can reach to value */
+  template <typename DataType, int dimensions, access::mode mode>
+  void fill(buffer_acc_t<DataType, dimensions, mode> dst,
+            const typename detail::base_host_data<DataType>::type& value) {
+    static_assert(mode != access::mode::read,
+                  "Cannot write through a read accessor");
+    group::check_scope();
+    auto bytes = reinterpret_cast<const char*>(&value);
+    group::add_fill(get_buffer_access(dst), get_region(dst),
+                    vector_class<char>(bytes, bytes + sizeof(value)));
+  }
+
+  /** Copies between two accessors reaching parts of the same size */
+  template <typename DataType, int dimensions, access::mode srcMode,
+            access::mode dstMode>
+  void copy(buffer_acc_t<DataType, dimensions, srcMode> src,
+            buffer_acc_t<DataType, dimensions, dstMode> dst) {
+    static_assert(dstMode != access::mode::read,
+                  "Cannot write through a read accessor");
+    group::check_scope();
+    group::add_copy(get_buffer_access(src), get_region(src),
+                    get_buffer_access(dst), get_region(dst));
+  }
+
+  /**
+   * Copies the part of the buffer the accessor can reach to host memory.
+   * The memory has to stay valid until the command group completes.
+   */
+  template <typename DataType, int dimensions, access::mode mode>
+  void copy(buffer_acc_t<DataType, dimensions, mode> src,
+            typename detail::base_host_data<DataType>::type* dst) {
+    group::check_scope();
+    check_not_partitioned();
+    auto src_region = get_region(src);
+    group::add_copy_to_host(get_buffer_access(src), src_region, dst,
+                            get_host_region(src_region));
+  }
+
+  /**
+   * Copies host memory to the part of the buffer the accessor can reach.
+   * The memory has to stay valid until the command group completes.
+   */
+  template <typename DataType, int dimensions, access::mode mode>
+  void copy(const typename detail::base_host_data<DataType>::type* src,
+            buffer_acc_t<DataType, dimensions, mode> dst) {
+    static_assert(mode != access::mode::read,
+                  "Cannot write through a read accessor");
+    group::check_scope();
+    check_not_partitioned();
+    auto dst_region = get_region(dst);
+    group::add_copy_from_host(src, get_host_region(dst_region),
+                              get_buffer_access(dst), dst_region);
+  }
+
+  /**
+   * Reads the buffer back to its host data.
+   * Host data is already updated after each command group that writes to the
+   * buffer, so this only orders the transfer among the commands of the group.
+   */
+  template <typename DataType, int dimensions, access::mode mode>
+  void update_host(buffer_acc_t<DataType, dimensions, mode> acc) {
+    group::check_scope();
+    // The device data is not newer if it can only be read
+    if (mode != access::mode::read) {
+      group::add_update_host(get_buffer_access(acc));
+    }
+  }
+
+  /**
+   * Runs the callable on a host thread once the commands added before it
+   * have completed, without blocking the submitting thread.
+   * The host data of the buffers accessed so far is current by then,
+   * and can be used through the get_host_pointer method of the accessors.
+   * Later commands using these buffers wait for the callable.
+   */
+  template <class HostTaskType>
+  void host_task(HostTaskType task) {
+    group::check_scope();
+    check_not_partitioned();
+    group::add_host_task(function_class<void()>(std::move(task)));
+  }
+
   // OpenCL interoperability invoke
 
   template <bool = true>
   void single_task(kernel syclKernel) {
+    check_not_partitioned();
     auto kern = shared_ptr_class<kernel>(new kernel(std::move(syclKernel)));
     issue_enqueue(kern, &issue::enqueue_task);
   }
 
   template <int dimensions>
   void parallel_for(range<dimensions> numWorkItems, kernel syclKernel) {
+    // Kernels from OpenCL sources cannot be rebased to sub-buffers
+    check_not_partitioned();
     auto kern = shared_ptr_class<kernel>(new kernel(std::move(syclKernel)));
     issue_enqueue(kern, &issue::enqueue_range, numWorkItems, id<dimensions>());
   }
 
   template <int dimensions>
   void parallel_for(nd_range<dimensions> ndRange, kernel syclKernel) {
+    check_not_partitioned();
     auto kern = shared_ptr_class<kernel>(new kernel(std::move(syclKernel)));
     issue_enqueue(kern, &issue::enqueue_nd_range, ndRange);
   }
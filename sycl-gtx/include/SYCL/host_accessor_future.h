@@ -0,0 +1,77 @@
+#pragma once
+
+// Asynchronous host accessors (extension)
+
+#include "SYCL/access.h"
+#include "SYCL/accessors/buffer.h"
+#include "SYCL/buffer.h"
+#include "SYCL/detail/common.h"
+#include "SYCL/detail/synchronizer.h"
+#include "SYCL/event.h"
+#include "SYCL/info.h"
+#include "SYCL/ranges.h"
+
+namespace cl {
+namespace sycl {
+
+/**
+ * Read access to a buffer that is being copied back to the host.
+ * Creating it flushes the commands using the buffer without waiting,
+ * so the host can work on other data in the meantime.
+ * The accessor only waits on the events of the buffer,
+ * not on everything else the queues are doing.
+ */
+template <typename DataType, int dimensions>
+class host_accessor_future {
+ public:
+  using accessor_t = accessor<DataType, dimensions, access::mode::read,
+                              access::target::host_buffer>;
+
+ private:
+  buffer<DataType, dimensions>* buf;
+  range<dimensions> offset;
+  range<dimensions> rang;
+  vector_class<event> events;
+
+ public:
+  host_accessor_future(buffer<DataType, dimensions>& bufferRef,
+                       range<dimensions> offset, range<dimensions> range)
+      : buf(&bufferRef),
+        offset(offset),
+        rang(range),
+        events(detail::synchronizer::request(buf)) {}
+
+  /** @return true if the host data is available without blocking */
+  bool is_ready() const {
+    for (auto& ev : events) {
+      // Failed commands are reported when waiting
+      if (ev.template get_info<info::event::command_execution_status>() >
+          CL_COMPLETE) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void wait() {
+    event::wait(events);
+  }
+
+  /** @return events of the transfers to the host */
+  vector_class<event> get_events() const {
+    return events;
+  }
+
+  /**
+   * Waits until the host data is available.
+   * Commands using the buffer submitted after the future was created
+   * are waited for as well.
+   */
+  accessor_t get() {
+    detail::synchronizer::synchronize(buf);
+    return accessor_t(*buf, offset, rang);
+  }
+};
+
+}  // namespace sycl
+}  // namespace cl
@@ -0,0 +1,202 @@
+#pragma once
+
+// 3.4.3 Images
+
+#include "SYCL/access.h"
+#include "SYCL/buffer_base.h"
+#include "SYCL/command_group.h"
+#include "SYCL/detail/common.h"
+#include "SYCL/detail/partition.h"
+#include "SYCL/error_handler.h"
+#include "SYCL/ranges.h"
+#include <array>
+
+namespace cl {
+namespace sycl {
+
+// Forward declarations
+template <typename, int, access::mode, access::target>
+class accessor;
+class handler;
+
+enum class image_channel_order {
+  r,
+  rg,
+  rgba,
+  bgra,
+  argb,
+  intensity,
+  luminance
+};
+
+enum class image_channel_type {
+  snorm_int8,
+  snorm_int16,
+  unorm_int8,
+  unorm_int16,
+  signed_int8,
+  signed_int16,
+  signed_int32,
+  unsigned_int8,
+  unsigned_int16,
+  unsigned_int32,
+  fp16,
+  fp32
+};
+
+namespace detail {
+
+// Forward declaration
+template <typename, int, access::mode, access::target, typename>
+class accessor_detail;
+
+class image_base : public buffer_base {
+ protected:
+  using region_t = std::array<::size_t, 3>;
+
+  shared_ptr_class<void> host_data;
+  image_channel_order order;
+  image_channel_type type;
+  int num_dimensions;
+  // 2D images have a depth of 1
+  region_t region;
+  bool is_read_only;
+  bool is_initialized = false;
+
+  image_base(void* host_data, bool is_read_only, image_channel_order order,
+             image_channel_type type, int num_dimensions, region_t region);
+  image_base(image_channel_order order, image_channel_type type,
+             int num_dimensions, region_t region);
+
+  static void create(queue* q, const vector_class<cl_event>& wait_events,
+                     image_base* img);
+  void init() final;
+  void enqueue(queue* q, const vector_class<cl_event>& wait_events,
+               clEnqueueBuffer_f clEnqueueBuffer) final;
+
+  template <access::mode mode>
+  void add_access() {
+    static_assert(mode == access::mode::read ||
+                      mode == access::mode::write ||
+                      mode == access::mode::discard_write,
+                  "Images are either read or written by a kernel");
+    command::group_detail::check_scope();
+    if (mode != access::mode::read) {
+      if (is_read_only) {
+        detail::error::report(error::code::TRYING_TO_WRITE_READ_ONLY_BUFFER);
+      }
+      // Each device would write the whole image
+      if (partition::current != nullptr) {
+        detail::error::report(error::code::NOT_PARTITIONABLE);
+      }
+    }
+    init();
+    command::group_detail::add_buffer_access(
+        buffer_access{this, mode, access::target::image}, __func__);
+  }
+
+ public:
+  image_base(const image_base&) = delete;
+  image_base& operator=(const image_base&) = delete;
+  ~image_base();
+
+  /** @return number of bytes of each pixel */
+  ::size_t get_element_size() const;
+
+  /** Total number of pixels in the image */
+  ::size_t get_count() const {
+    return region[0] * region[1] * region[2];
+  }
+
+  /** Total number of bytes in the image */
+  ::size_t get_size() const {
+    return get_count() * get_element_size();
+  }
+
+  image_channel_order get_channel_order() const {
+    return order;
+  }
+
+  image_channel_type get_channel_type() const {
+    return type;
+  }
+};
+
+}  // namespace detail
+
+/**
+ * Image memory object, read and written by kernels through the texture path.
+ * Pixels are tightly packed in the host data, dimension 0 being contiguous.
+ * The host data is current once the kernels writing the image
+ * have completed, the latest when the image is destroyed.
+ */
+template <int dimensions>
+class image : public detail::image_base {
+  static_assert(dimensions == 2 || dimensions == 3,
+                "Only 2D and 3D images are supported");
+
+ private:
+  template <typename, int, access::mode, access::target, typename>
+  friend class detail::accessor_detail;
+
+  static region_t get_region(const range<dimensions>& range) {
+    region_t region = {1, 1, 1};
+    for (int i = 0; i < dimensions; ++i) {
+      region[i] = range.get(i);
+    }
+    return region;
+  }
+
+ public:
+  image(void* hostPointer, image_channel_order order, image_channel_type type,
+        const range<dimensions>& range)
+      : image_base(hostPointer, false, order, type, dimensions,
+                   get_region(range)) {}
+
+  /** The image is read-only, the host data is never written */
+  image(const void* hostPointer, image_channel_order order,
+        image_channel_type type, const range<dimensions>& range)
+      : image_base(const_cast<void*>(hostPointer),  // NOLINT
+                   true, order, type, dimensions, get_region(range)) {}
+
+  /** Creates an image with host data managed by the runtime */
+  image(image_channel_order order, image_channel_type type,
+        const range<dimensions>& range)
+      : image_base(order, type, dimensions, get_region(range)) {}
+
+  range<dimensions> get_range() const {
+    range<dimensions> rang;
+    for (int i = 0; i < dimensions; ++i) {
+      rang[i] = region[i];
+    }
+    return rang;
+  }
+
+  /**
+   * Device access to the image.
+   * The data type is the type of a pixel in kernels,
+   * such as cl_float4, cl_int4 or cl_uint4.
+   */
+  template <typename DataType, access::mode mode>
+  accessor<DataType, dimensions, mode, access::target::image> get_access(
+      handler& cgh) {
+    add_access<mode>();
+    return accessor<DataType, dimensions, mode, access::target::image>(*this,
+                                                                       cgh);
+  }
+
+  /**
+   * Host access to the image,
+   * waiting for the kernels using it to complete.
+   * The host type of the data type is the type of a pixel in the host data.
+   */
+  template <typename DataType, access::mode mode>
+  accessor<DataType, dimensions, mode, access::target::host_image>
+  get_access() {
+    return accessor<DataType, dimensions, mode, access::target::host_image>(
+        *this);
+  }
+};
+
+}  // namespace sycl
+}  // namespace cl
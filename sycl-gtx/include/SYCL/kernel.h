@@ -17,16 +17,24 @@ namespace cl {
 namespace sycl {
 
 // Forward declarations
+class command_graph;
 class context;
 class event;
 class queue;
 class program;
 
+namespace detail {
+class trace_memo_registry;
+}
+
 class kernel {
  private:
+  friend class command_graph;
   friend class program;
+  friend class detail::command_group;
   friend class detail::issue_command;
   friend class detail::kernel_ns::source;
+  friend class detail::trace_memo_registry;
 
   detail::refc<cl_kernel, clRetainKernel, clReleaseKernel> kern;
   context ctx;
@@ -82,7 +90,8 @@ class kernel {
   }
 
  private:
-  static cl_event get_cl_event(event* evnt);
+  /** Hands over the reference returned by an enqueue function */
+  static void set_cl_event(event* evnt, cl_event ev);
   static cl_command_queue get_cl_queue(queue* q);
 
   static const cl_event* get_events_ptr(
@@ -99,13 +108,14 @@ class kernel {
                      id<dimensions> offset) const {
     ::size_t* global_work_size = &num_work_items[0];
     ::size_t* offst = &static_cast<::size_t&>(offset[0]);
-    auto ev = get_cl_event(evnt);
+    cl_event ev;
 
     auto error_code = clEnqueueNDRangeKernel(
         get_cl_queue(q), kern.get(), dimensions, offst, global_work_size,
         nullptr, static_cast<::cl_uint>(wait_events.size()),
         get_events_ptr(wait_events), &ev);
     detail::error::report(error_code);
+    set_cl_event(evnt, ev);
   }
 
   template <int dimensions>
@@ -127,13 +137,14 @@ class kernel {
       }
     }
 
-    auto ev = get_cl_event(evnt);
+    cl_event ev;
 
     auto error_code = clEnqueueNDRangeKernel(
         get_cl_queue(q), kern.get(), dimensions, offst, global_work_size,
         local_work_size, static_cast<::cl_uint>(wait_events.size()),
         get_events_ptr(wait_events), &ev);
     detail::error::report(error_code);
+    set_cl_event(evnt, ev);
   }
 };
 
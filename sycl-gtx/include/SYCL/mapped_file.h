@@ -0,0 +1,68 @@
+#pragma once
+
+// Files mapped into memory as host data of buffers (extension)
+
+#include "SYCL/detail/common.h"
+
+namespace cl {
+namespace sycl {
+
+namespace detail {
+// Forward declaration
+template <typename, int>
+class buffer_detail;
+}  // namespace detail
+
+/**
+ * Part of a file mapped into memory.
+ * Buffers constructed from it use the mapping as their host data,
+ * so the file is copied to the device straight from the page cache.
+ * The mapping stays valid while a buffer or a copy of this object uses it.
+ */
+class mapped_file {
+ public:
+  enum class mode {
+    // Buffers constructed from the file are read-only
+    read_only,
+    // Changes stay in memory and never reach the file
+    copy_on_write
+  };
+
+ private:
+  template <typename, int>
+  friend class detail::buffer_detail;
+
+  shared_ptr_class<void> mapping;
+  ::size_t length = 0;
+  mode map_mode;
+
+  void map(int fd, ::size_t offset, ::size_t size);
+
+ public:
+  /**
+   * Maps length bytes of the file at path, starting at offset.
+   * A length of 0 maps the rest of the file.
+   */
+  explicit mapped_file(const string_class& path, mode mapMode = mode::read_only,
+                       ::size_t offset = 0, ::size_t length = 0);
+
+  /** Maps part of an open file, the descriptor can be closed afterwards */
+  mapped_file(int fd, ::size_t offset, ::size_t length,
+              mode mapMode = mode::read_only);
+
+  void* get() const {
+    return mapping.get();
+  }
+
+  /** @return size of the mapping in bytes */
+  ::size_t size() const {
+    return length;
+  }
+
+  mode get_mode() const {
+    return map_mode;
+  }
+};
+
+}  // namespace sycl
+}  // namespace cl
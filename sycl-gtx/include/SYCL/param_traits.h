@@ -1,6 +1,7 @@
 #pragma once
 
 #include "SYCL/detail/common.h"
+#include "SYCL/detail/info_cache.h"
 #include "SYCL/info.h"
 
 namespace cl {
@@ -377,13 +378,22 @@ struct array_traits : traits<Contained_t, BufferSize_v> {
 
   template <typename cl_input_t>
   return_t get(cl_input_t data_ptr) {
-    auto error_code = info_function<EnumClass>::get(
-        data_ptr,
-        static_cast<typename param_traits<EnumClass, param>::cl_flag_type>(
-            param),
-        RealBase::BufferSizeConstant * RealBase::type_size, param_value,
-        &actual_size);
-    error::report(error_code);
+    using cl_flag_type = typename param_traits<EnumClass, param>::cl_flag_type;
+    auto is_cached = is_immutable_info<EnumClass, param>::value &&
+                     (!is_root_only_info<EnumClass>::value ||
+                      info_cache::is_root(data_ptr));
+    auto flag = static_cast<cl_flag_type>(param);
+    auto size = RealBase::BufferSizeConstant * RealBase::type_size;
+
+    if (!is_cached ||
+        !info_cache::get(data_ptr, flag, size, param_value, &actual_size)) {
+      auto error_code = info_function<EnumClass>::get(
+          data_ptr, flag, size, param_value, &actual_size);
+      error::report(error_code);
+      if (is_cached) {
+        info_cache::set(data_ptr, flag, param_value, actual_size);
+      }
+    }
     return trait_return<BufferSize_v == 1>::get(param_value);
   }
 };
@@ -22,7 +22,9 @@ class platform {
 
   platform(cl_platform_id platform_id, device_selector& dev_selector);
 
+  // Platforms don't change while the program runs
   static vector_class<platform> platforms;
+  static mutex_class platforms_mutex;
 
  public:
   /**
@@ -31,6 +31,7 @@ class program {
 
   detail::refc<cl_program, clRetainProgram, clReleaseProgram> prog;
   bool linked = false;
+  string_class build_options;
 
   context ctx;
   vector_class<device> devices;
@@ -46,13 +47,20 @@ class program {
                shared_ptr_class<kernel> kern);
   void report_compile_error(shared_ptr_class<kernel> kern, device& dev) const;
 
+  /** Generates the kernel source without compiling it */
   template <class KernelType>
-  void compile(KernelType kernFunctor, string_class compile_options = "") {
+  static shared_ptr_class<kernel> trace(KernelType kernFunctor) {
     auto src = detail::kernel_ns::constructor<
         typename detail::first_arg<KernelType>::type>::get(kernFunctor);
     auto kern = shared_ptr_class<kernel>(new kernel(true));
     kern->src = std::move(src);
-    compile(compile_options, detail::kernel_name::get<KernelType>(), kern);
+    return kern;
+  }
+
+  template <class KernelType>
+  void compile(KernelType kernFunctor, string_class compile_options = "") {
+    compile(compile_options, detail::kernel_name::get<KernelType>(),
+            trace(kernFunctor));
   }
 
   template <class KernelType>
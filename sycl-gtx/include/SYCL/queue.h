@@ -9,6 +9,7 @@
 #include "SYCL/detail/synchronizer.h"
 #include "SYCL/device.h"
 #include "SYCL/error_handler.h"
+#include "SYCL/flush_policy.h"
 #include "SYCL/handler_event.h"
 #include "SYCL/info.h"
 #include "SYCL/param_traits.h"
@@ -17,22 +18,44 @@
 namespace cl {
 namespace sycl {
 
+// Forward declaration
+class command_graph;
+
 /** Encapsulation of an OpenCL cl_command_queue */
 class queue {
  private:
+  friend class detail::buffer_base;
+  friend class detail::command_group;
   friend class detail::synchronizer;
 
   using buffer_set = std::set<detail::buffer_base*>;
 
   context ctx;
   device dev;
+  // Needs to be initialized before the command group is executed
+  string_class compile_opts;
+  bool kernel_fusion = false;
   detail::refc<cl_command_queue, clRetainCommandQueue, clReleaseCommandQueue>
       command_q;
-  exception_list ex_list;
+  // Copies overlap kernels on this queue, shared with the subqueues
+  detail::refc<cl_command_queue, clRetainCommandQueue, clReleaseCommandQueue>
+      transfer_q;
+  // Set while a copy is enqueued
+  bool is_transferring = false;
+  shared_ptr_class<detail::async_error_list> ex_list =
+      std::make_shared<detail::async_error_list>();
   detail::command_group command_group;
   buffer_set buffers_in_use;
   bool is_flushed = true;
   vector_class<queue> subqueues;
+  // Subqueue with a kernel waiting to be fused, -1 if there is none
+  int deferred = -1;
+  // Command groups are gathered in command_group until the window is full
+  flush_policy policy = flush_policy::every_group();
+  ::size_t window_groups = 0;
+  std::chrono::steady_clock::time_point window_start;
+  // Command groups are also recorded into this graph while it is set
+  shared_ptr_class<command_graph> recording;
 
   void display_device_info() const;
   cl_command_queue create_queue(bool display_info = true,
@@ -81,7 +104,11 @@ class queue {
   queue(queue* master, T cgf)
       : ctx(master->ctx),
         dev(master->dev),
+        compile_opts(master->compile_opts),
+        kernel_fusion(master->kernel_fusion),
         command_q(create_queue(false, false)),
+        transfer_q(master->transfer_q),
+        ex_list(master->ex_list),
         command_group(*this, cgf),
         is_flushed(false) {}
 
@@ -99,12 +126,21 @@ class queue {
   queue(queue&& move) noexcept
       : SYCL_MOVE_INIT(ctx),
         SYCL_MOVE_INIT(dev),
+        SYCL_MOVE_INIT(compile_opts),
+        SYCL_MOVE_INIT(kernel_fusion),
         SYCL_MOVE_INIT(command_q),
+        SYCL_MOVE_INIT(transfer_q),
+        SYCL_MOVE_INIT(is_transferring),
         SYCL_MOVE_INIT(ex_list),
         SYCL_MOVE_INIT(command_group),
         SYCL_MOVE_INIT(buffers_in_use),
         SYCL_MOVE_INIT(is_flushed),
-        SYCL_MOVE_INIT(subqueues) {
+        SYCL_MOVE_INIT(subqueues),
+        SYCL_MOVE_INIT(deferred),
+        SYCL_MOVE_INIT(policy),
+        SYCL_MOVE_INIT(window_groups),
+        SYCL_MOVE_INIT(window_start),
+        SYCL_MOVE_INIT(recording) {
     move.command_q = nullptr;
     command_group.q = this;
   }
@@ -116,12 +152,21 @@ class queue {
     using std::swap;
     SYCL_SWAP(ctx);
     SYCL_SWAP(dev);
+    SYCL_SWAP(compile_opts);
+    SYCL_SWAP(kernel_fusion);
     SYCL_SWAP(command_q);
+    SYCL_SWAP(transfer_q);
+    SYCL_SWAP(is_transferring);
     SYCL_SWAP(ex_list);
     SYCL_SWAP(command_group);
     SYCL_SWAP(buffers_in_use);
     SYCL_SWAP(is_flushed);
     SYCL_SWAP(subqueues);
+    SYCL_SWAP(deferred);
+    SYCL_SWAP(policy);
+    SYCL_SWAP(window_groups);
+    SYCL_SWAP(window_start);
+    SYCL_SWAP(recording);
   }
 
   bool is_host();
@@ -137,6 +182,89 @@ class queue {
   /** Returns the SYCL device the queue is associated with. */
   device get_device() const;
 
+  /**
+   * Sets the compile options used for all kernels submitted to this queue.
+   * Options attached to a kernel name are appended to these.
+   */
+  void set_compile_options(string_class compile_options);
+
+  /** Returns the compile options used for kernels submitted to this queue. */
+  string_class get_compile_options() const;
+
+  /**
+   * Enables fusion of adjacent range kernels.
+   * A submitted range kernel is then held back until the next submission.
+   * If that is a range kernel with the same range and compile options,
+   * and the buffers written by either kernel are only accessed
+   * at the id of the work item, the two become one kernel.
+   * Held back kernels are submitted on wait, on host access
+   * to one of their buffers and when one of their buffers is destroyed.
+   */
+  void set_kernel_fusion(bool enable);
+
+  /** Returns true if adjacent range kernels are fused. */
+  bool get_kernel_fusion() const;
+
+  /**
+   * Gathers up to the given number of command groups
+   * and flushes them together, in order on this queue.
+   * Transfers that are redundant across the groups are dropped,
+   * such as writing back to the device a buffer that was just read from it,
+   * and kernels are launched before unrelated reads.
+   * Groups are also flushed on wait, on host access to one of their buffers
+   * and when one of their buffers is destroyed.
+   * The default of 1 flushes each group on submission.
+   * Same as setting the flush policy to flush_policy::every(groups).
+   */
+  void set_submission_window(::size_t groups);
+
+  /**
+   * Returns the number of command groups gathered before flushing,
+   * 0 if the flush policy doesn't limit it.
+   */
+  ::size_t get_submission_window() const;
+
+  /**
+   * Sets when gathered command groups are flushed,
+   * so that many small submissions reach the device together.
+   */
+  void set_flush_policy(flush_policy flushPolicy);
+
+  /** Returns the policy for flushing gathered command groups. */
+  flush_policy get_flush_policy() const;
+
+  /**
+   * Enqueues copies between the host and the device
+   * on a separate OpenCL queue of the same device,
+   * so that they can overlap kernels that don't use the same buffers.
+   * Copies and kernels using the same buffer are ordered by their events.
+   */
+  void set_transfer_overlap(bool enable);
+
+  /** Returns true if copies have their own queue. */
+  bool get_transfer_overlap() const;
+
+  /**
+   * Starts recording the command groups submitted to this queue.
+   * They are still executed as usual.
+   */
+  void begin_recording();
+
+  /**
+   * Stops recording and returns the recorded commands,
+   * with the transfers optimized across all of the recorded groups
+   */
+  command_graph end_recording();
+
+  /** Returns true between begin_recording and end_recording. */
+  bool is_recording() const;
+
+  /**
+   * Enqueues the commands of the graph as a single command group.
+   * The graph must not change or be destroyed until the queue is flushed.
+   */
+  handler_event replay(command_graph& graph);
+
   template <info::queue param>
   typename param_traits<info::queue, param>::type get_info() const {
     return detail::non_vector_traits<info::queue, param, 1>().get(
@@ -167,7 +295,10 @@ class queue {
   template <typename T>
   handler_event submit(T cgf) {
     subqueues.push_back({this, cgf});
-    return subqueues.back().process(buffers_in_use);
+    if (kernel_fusion) {
+      return submit_deferred();
+    }
+    return schedule(subqueues.back());
   }
 
   // TODO(progtx):
@@ -177,7 +308,15 @@ class queue {
  private:
   void flush();
   void finish();
+  /** Queue that the copy being enqueued goes to */
+  cl_command_queue get_copy_queue();
   void wait_subqueues(bool and_throw);
+  handler_event submit_deferred();
+  void flush_deferred();
+  handler_event schedule(queue& subqueue);
+  void flush_window();
+  bool is_window_full() const;
+  void track_buffers(const detail::command_group& group);
   handler_event process(buffer_set& buffers_in_use_master);
   static vector_class<cl_event> get_wait_events(const buffer_set& dependencies,
                                                 buffer_set& buffers_in_use);
@@ -0,0 +1,64 @@
+#pragma once
+
+// Image samplers
+
+#include "SYCL/detail/common.h"
+
+namespace cl {
+namespace sycl {
+
+namespace detail {
+namespace kernel_ns {
+// Forward declaration
+class source;
+}  // namespace kernel_ns
+}  // namespace detail
+
+enum class coordinate_normalization_mode { normalized, unnormalized };
+
+enum class addressing_mode {
+  mirrored_repeat,
+  repeat,
+  clamp_to_edge,
+  clamp,
+  none
+};
+
+enum class filtering_mode { nearest, linear };
+
+/**
+ * Describes how image accessors read their image.
+ * Kernels using a sampler get it as a constant in their source,
+ * so it does not take a kernel argument.
+ * Linear filtering interpolates in hardware on devices that support it.
+ */
+class sampler {
+ private:
+  friend class detail::kernel_ns::source;
+
+  coordinate_normalization_mode normalization;
+  addressing_mode addressing;
+  filtering_mode filtering;
+
+ public:
+  sampler(coordinate_normalization_mode normalizationMode,
+          addressing_mode addressingMode, filtering_mode filteringMode)
+      : normalization(normalizationMode),
+        addressing(addressingMode),
+        filtering(filteringMode) {}
+
+  coordinate_normalization_mode get_coordinate_normalization_mode() const {
+    return normalization;
+  }
+
+  addressing_mode get_addressing_mode() const {
+    return addressing;
+  }
+
+  filtering_mode get_filtering_mode() const {
+    return filtering;
+  }
+};
+
+}  // namespace sycl
+}  // namespace cl
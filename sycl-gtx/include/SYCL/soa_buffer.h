@@ -0,0 +1,317 @@
+#pragma once
+
+// Structure of arrays buffers (extension)
+
+#include "SYCL/access.h"
+#include "SYCL/accessors/buffer.h"
+#include "SYCL/buffer.h"
+#include "SYCL/detail/common.h"
+#include "SYCL/ranges.h"
+#include <tuple>
+
+namespace cl {
+namespace sycl {
+
+// Forward declaration
+class handler;
+
+namespace detail {
+namespace soa {
+
+template <::size_t...>
+struct indices {};
+template <::size_t n, ::size_t... is>
+struct make_indices : make_indices<n - 1, n - 1, is...> {};
+template <::size_t... is>
+struct make_indices<0, is...> {
+  using type = indices<is...>;
+};
+
+// Same value for each field
+template <typename, typename T>
+const T& repeat(const T& value) {
+  return value;
+}
+
+// Evaluates the expression once for each field, in order
+#define SYCL_SOA_FOR_EACH(expression)       \
+  int expand[] = {0, ((expression), 0)...}; \
+  (void)expand
+
+}  // namespace soa
+}  // namespace detail
+
+/**
+ * Element of a structure of arrays buffer in host memory.
+ * Fields are accessed in place, while the whole structure
+ * is gathered from and scattered to the field arrays.
+ */
+template <typename Struct, typename... Fields>
+class soa_host_ref {
+ private:
+  template <typename, int, access::mode, typename...>
+  friend class soa_host_accessor;
+  template <typename, int, typename...>
+  friend class soa_buffer;
+
+  using members_t = std::tuple<Fields Struct::*...>;
+  using pointers_t = std::tuple<Fields*...>;
+  using indices_t =
+      typename detail::soa::make_indices<sizeof...(Fields)>::type;
+
+  const members_t* members;
+  const pointers_t* pointers;
+  ::size_t index;
+
+  soa_host_ref(const members_t* members, const pointers_t* pointers,
+               ::size_t index)
+      : members(members), pointers(pointers), index(index) {}
+
+  template <::size_t... is>
+  void gather(Struct& value, detail::soa::indices<is...>) const {
+    SYCL_SOA_FOR_EACH(value.*std::get<is>(*members) =
+                          std::get<is>(*pointers)[index]);
+  }
+  template <::size_t... is>
+  void scatter(const Struct& value, detail::soa::indices<is...>) {
+    SYCL_SOA_FOR_EACH(std::get<is>(*pointers)[index] =
+                          value.*std::get<is>(*members));
+  }
+
+ public:
+  /** @return reference to field i of the element */
+  template <::size_t i>
+  typename std::tuple_element<i, std::tuple<Fields...>>::type& get() const {
+    return std::get<i>(*pointers)[index];
+  }
+
+  operator Struct() const {
+    Struct value;
+    gather(value, indices_t());
+    return value;
+  }
+
+  soa_host_ref& operator=(const Struct& value) {
+    scatter(value, indices_t());
+    return *this;
+  }
+};
+
+/**
+ * Host access to a structure of arrays buffer,
+ * viewed as an array of structures.
+ */
+template <typename Struct, int dimensions, access::mode mode,
+          typename... Fields>
+class soa_host_accessor {
+ private:
+  using members_t = std::tuple<Fields Struct::*...>;
+  using pointers_t = std::tuple<Fields*...>;
+  using accessors_t = std::tuple<
+      accessor<Fields, dimensions, mode, access::target::host_buffer>...>;
+  using ref_t = soa_host_ref<Struct, Fields...>;
+
+  const members_t* members;
+  accessors_t accessors;
+  pointers_t pointers;
+  ::size_t count;
+
+  template <::size_t... is>
+  static pointers_t get_pointers(const accessors_t& accessors,
+                                 detail::soa::indices<is...>) {
+    // Fields of read accessors are only read through the reference
+    return pointers_t(
+        const_cast<Fields*>(std::get<is>(accessors).get_pointer())...);
+  }
+
+ public:
+  template <typename... Buffers>
+  soa_host_accessor(const members_t* members, ::size_t count,
+                    Buffers&... buffers)
+      : members(members),
+        accessors(buffers...),
+        pointers(get_pointers(
+            accessors,
+            typename detail::soa::make_indices<sizeof...(Fields)>::type())),
+        count(count) {}
+
+  /** @return element at the linear index, dimension 0 being contiguous */
+  ref_t operator[](::size_t index) const {
+    return ref_t(members, &pointers, index);
+  }
+
+  /** @return number of elements in the buffer */
+  ::size_t size() const {
+    return count;
+  }
+};
+
+/**
+ * Element of a structure of arrays buffer in kernel source.
+ * Each field is read from and written to its own array,
+ * so work items reading the same field access consecutive addresses.
+ */
+template <int dimensions, access::mode mode, access::target target,
+          typename... Fields>
+class soa_device_ref {
+ private:
+  template <typename, int, access::mode, access::target, typename...>
+  friend class soa_device_accessor;
+
+  using accessors_t =
+      std::tuple<accessor<Fields, dimensions, mode, target>...>;
+  template <::size_t i>
+  using return_t = typename detail::acc_device_return<
+      typename std::tuple_element<i, std::tuple<Fields...>>::type>::type;
+
+  const accessors_t* accessors;
+  id<dimensions> index;
+
+  soa_device_ref(const accessors_t* accessors, id<dimensions> index)
+      : accessors(accessors), index(index) {}
+
+ public:
+  /** @return field i of the element */
+  template <::size_t i>
+  return_t<i> get() const {
+    return std::get<i>(*accessors)[index];
+  }
+};
+
+/** Device access to the fields of a structure of arrays buffer */
+template <typename Struct, int dimensions, access::mode mode,
+          access::target target, typename... Fields>
+class soa_device_accessor {
+ private:
+  using accessors_t =
+      std::tuple<accessor<Fields, dimensions, mode, target>...>;
+  using ref_t = soa_device_ref<dimensions, mode, target, Fields...>;
+
+  accessors_t accessors;
+
+ public:
+  explicit soa_device_accessor(
+      accessor<Fields, dimensions, mode, target>... accessors)
+      : accessors(accessors...) {}
+
+  ref_t operator[](id<dimensions> index) const {
+    return ref_t(&accessors, index);
+  }
+
+  /** @return device accessor of field i */
+  template <::size_t i>
+  const typename std::tuple_element<i, accessors_t>::type& get_field() const {
+    return std::get<i>(accessors);
+  }
+};
+
+/**
+ * Buffer of structures stored as a structure of arrays.
+ * Each field described by a member pointer is kept in its own buffer,
+ * which kernels access with coalesced loads and stores
+ * of only the fields they use.
+ * Fields of the structure that are not described are not stored.
+ * If the buffer was created from host data,
+ * the described fields are gathered back into it when the buffer is destroyed,
+ * leaving the other fields of the host data unchanged.
+ */
+template <typename Struct, int dimensions, typename... Fields>
+class soa_buffer {
+ private:
+  using members_t = std::tuple<Fields Struct::*...>;
+  using buffers_t = std::tuple<buffer<Fields, dimensions>...>;
+  using indices_t =
+      typename detail::soa::make_indices<sizeof...(Fields)>::type;
+
+  members_t members;
+  buffers_t buffers;
+  range<dimensions> rang;
+  Struct* final_data = nullptr;
+
+  template <access::mode mode, ::size_t... is>
+  soa_host_accessor<Struct, dimensions, mode, Fields...> get_access_host(
+      detail::soa::indices<is...>) {
+    return soa_host_accessor<Struct, dimensions, mode, Fields...>(
+        &members, get_count(), std::get<is>(buffers)...);
+  }
+
+  template <access::mode mode, access::target target, ::size_t... is>
+  soa_device_accessor<Struct, dimensions, mode, target, Fields...>
+  get_access_device(handler& cgh, detail::soa::indices<is...>) {
+    return soa_device_accessor<Struct, dimensions, mode, target, Fields...>(
+        std::get<is>(buffers).template get_access<mode, target>(cgh)...);
+  }
+
+  void copy_from(const Struct* host_data) {
+    auto acc = get_access<access::mode::discard_write>();
+    for (::size_t i = 0; i < acc.size(); ++i) {
+      acc[i] = host_data[i];
+    }
+  }
+
+ public:
+  soa_buffer(const range<dimensions>& range, Fields Struct::*... members)
+      : members(members...),
+        buffers(detail::soa::repeat<Fields>(range)...),
+        rang(range) {}
+  soa_buffer(Struct* host_data, const range<dimensions>& range,
+             Fields Struct::*... members)
+      : soa_buffer(range, members...) {
+    copy_from(host_data);
+    final_data = host_data;
+  }
+  soa_buffer(const Struct* host_data, const range<dimensions>& range,
+             Fields Struct::*... members)
+      : soa_buffer(range, members...) {
+    copy_from(host_data);
+  }
+
+  // Host data is gathered once
+  soa_buffer(const soa_buffer&) = delete;
+  soa_buffer& operator=(const soa_buffer&) = delete;
+
+  ~soa_buffer() {
+    if (final_data != nullptr) {
+      auto acc = get_access<access::mode::read>();
+      for (::size_t i = 0; i < acc.size(); ++i) {
+        acc[i].gather(final_data[i], indices_t());
+      }
+    }
+  }
+
+  template <access::mode mode,
+            access::target target = access::target::global_buffer>
+  soa_device_accessor<Struct, dimensions, mode, target, Fields...> get_access(
+      handler& cgh) {
+    return get_access_device<mode, target>(cgh, indices_t());
+  }
+
+  template <access::mode mode>
+  soa_host_accessor<Struct, dimensions, mode, Fields...> get_access() {
+    return get_access_host<mode>(indices_t());
+  }
+
+  /** @return buffer storing field i */
+  template <::size_t i>
+  typename std::tuple_element<i, buffers_t>::type& get_field() {
+    return std::get<i>(buffers);
+  }
+
+  range<dimensions> get_range() const {
+    return rang;
+  }
+
+  ::size_t get_count() const {
+    return std::get<0>(buffers).get_count();
+  }
+
+  /** Stops gathering the fields into the host data on destruction */
+  void set_final_data(std::nullptr_t) {
+    final_data = nullptr;
+  }
+};
+
+#undef SYCL_SOA_FOR_EACH
+
+}  // namespace sycl
+}  // namespace cl
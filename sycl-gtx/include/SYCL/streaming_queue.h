@@ -0,0 +1,96 @@
+#pragma once
+
+// Extension: parallel_for streamed through the device in chunks
+
+#include "SYCL/context.h"
+#include "SYCL/detail/common.h"
+#include "SYCL/detail/partition.h"
+#include "SYCL/device.h"
+#include "SYCL/error_handler.h"
+#include "SYCL/queue.h"
+#include "SYCL/ranges.h"
+#include <algorithm>
+
+namespace cl {
+namespace sycl {
+
+/**
+ * Executes range based kernels over buffers larger than the device memory.
+ * The range is split along the last dimension into chunks,
+ * and each chunk of a buffer accessed with that range
+ * is a buffer of its own, using the host data of the chunk.
+ * Copies run on a separate queue, so while one chunk is computed
+ * the next one is uploaded and the previous one is read back.
+ */
+class streaming_queue {
+ private:
+  queue q;
+  // Work items of a chunk along the last dimension
+  ::size_t chunk_size;
+  // Chunks in flight, each one is reused once the chunks after it are issued
+  vector_class<detail::partition> chunks;
+  ::size_t next = 0;
+
+ public:
+  /**
+   * Creates a queue keeping up to depth chunks on the device,
+   * 2 for double buffering and 3 for triple buffering
+   */
+  explicit streaming_queue(
+      ::size_t chunkSize, ::size_t depth = 2,
+      const async_handler& asyncHandler = detail::default_async_handler);
+
+  streaming_queue(
+      const context& syclContext, const device& syclDevice,
+      ::size_t chunkSize, ::size_t depth = 2,
+      const async_handler& asyncHandler = detail::default_async_handler);
+
+  streaming_queue(const streaming_queue&) = delete;
+  streaming_queue& operator=(const streaming_queue&) = delete;
+
+  /**
+   * Submits the command group function once for each chunk of numWorkItems.
+   * Kernels must be range based parallel_for calls over numWorkItems.
+   * Buffers written by them must have the same last dimension as the range,
+   * other buffers are copied whole to the device for every chunk.
+   * Reusing the device memory of a chunk waits for its commands,
+   * and the host data of the buffers must not be accessed until wait.
+   */
+  template <int dimensions, typename T>
+  void submit(range<dimensions> numWorkItems, T cgf) {
+    ::size_t total = numWorkItems[dimensions - 1];
+
+    for (::size_t offset = 0; offset < total; offset += chunk_size) {
+      auto& part = chunks[next];
+      next = (next + 1) % chunks.size();
+      // Releases the buffers of the chunk that used the slot before
+      part = {dimensions, total, offset, std::min(chunk_size, total - offset),
+              true};
+
+      detail::partition::current = &part;
+      try {
+        q.submit(cgf);
+      } catch (...) {
+        detail::partition::current = nullptr;
+        throw;
+      }
+      detail::partition::current = nullptr;
+    }
+  }
+
+  /** Waits for all chunks and releases their device memory */
+  void wait();
+  void wait_and_throw();
+
+  ::size_t get_chunk_size() const {
+    return chunk_size;
+  }
+
+  /** @return number of chunks kept on the device */
+  ::size_t get_depth() const {
+    return chunks.size();
+  }
+};
+
+}  // namespace sycl
+}  // namespace cl
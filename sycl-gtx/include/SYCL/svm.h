@@ -0,0 +1,225 @@
+#pragma once
+
+// Shared virtual memory allocations (extension)
+
+#include "SYCL/access.h"
+#include "SYCL/accessor.h"
+#include "SYCL/accessors/device_reference.h"
+#include "SYCL/buffer_base.h"
+#include "SYCL/command_group.h"
+#include "SYCL/context.h"
+#include "SYCL/detail/common.h"
+#include "SYCL/detail/data_ref.h"
+#include "SYCL/detail/partition.h"
+#include "SYCL/detail/src_handlers/register_resource.h"
+#include "SYCL/detail/synchronizer.h"
+#include "SYCL/error_handler.h"
+#include "SYCL/refc.h"
+
+// Only available when compiling against OpenCL 2.0,
+// by defining CL_TARGET_OPENCL_VERSION as 200 or higher
+#ifdef CL_VERSION_2_0
+
+namespace cl {
+namespace sycl {
+
+// Forward declarations
+class handler;
+class queue;
+template <typename, access::mode>
+class svm_host_accessor;
+
+enum class svm_mode {
+  /** The host maps the allocation to access it */
+  coarse_grain,
+  /** The host accesses the allocation directly, between kernels */
+  fine_grain
+};
+
+namespace detail {
+
+// Forward declaration
+class issue_command;
+
+class svm_base : public buffer_base {
+ protected:
+  friend class issue_command;
+  template <typename, access::mode>
+  friend class ::cl::sycl::svm_host_accessor;
+
+  context ctx;
+  refc<cl_command_queue, clRetainCommandQueue, clReleaseCommandQueue> map_q;
+  void* pointer;
+  ::size_t size;
+  svm_mode grain;
+
+  svm_base(queue& q, ::size_t size, svm_mode grain);
+
+  template <access::mode mode>
+  void add_access() {
+    command::group_detail::check_scope();
+    // Devices of a distributed queue don't share the allocation
+    if (partition::current != nullptr) {
+      detail::error::report(error::code::NOT_PARTITIONABLE);
+    }
+    command::group_detail::add_buffer_access(
+        buffer_access{this, mode, access::target::svm}, __func__);
+  }
+
+  /** Waits for the kernels using the allocation, mapping it if needed */
+  void map(bool is_read_only);
+  void unmap();
+
+ public:
+  svm_base(const svm_base&) = delete;
+  svm_base& operator=(const svm_base&) = delete;
+  ~svm_base();
+
+  /** Total number of bytes in the allocation */
+  ::size_t get_size() const {
+    return size;
+  }
+
+  svm_mode get_mode() const {
+    return grain;
+  }
+};
+
+}  // namespace detail
+
+/**
+ * Shared virtual memory in kernel source, passed to the kernel as a pointer.
+ * The allocation is never copied, kernels use it in place.
+ */
+template <typename DataType, access::mode mode>
+class svm_pointer {
+ private:
+  template <typename>
+  friend class svm_allocation;
+
+  using return_t = typename detail::acc_device_return<DataType>::type;
+
+  detail::svm_base* svm;
+
+  explicit svm_pointer(detail::svm_base* svm) : svm(svm) {}
+
+  return_t subscript(const string_class& index) const {
+    auto resource_name = detail::kernel_ns::register_svm(
+        svm, mode, detail::pointer_type_string<DataType>::get());
+    return detail::acc_device_element<DataType>::get(resource_name, index);
+  }
+
+ public:
+  return_t operator[](const detail::data_ref& index) const {
+    return subscript(index.name);
+  }
+  return_t operator[](::size_t index) const {
+    return subscript(detail::data_ref::get_name(index));
+  }
+};
+
+/**
+ * Memory shared by the host and the devices of one context,
+ * allocated with clSVMAlloc.
+ * Kernels receive the allocation as a pointer, without copies,
+ * and data structures in it can keep pointers to each other.
+ * Each command group declares the allocations its kernel uses,
+ * either through get_pointer or, for allocations the kernel only reaches
+ * through pointers stored in other allocations, through require.
+ */
+template <typename DataType>
+class svm_allocation : public detail::svm_base {
+ public:
+  using value_type = DataType;
+
+  svm_allocation(queue& q, ::size_t count,
+                 svm_mode grain = svm_mode::coarse_grain)
+      : svm_base(q, count * sizeof(DataType), grain) {}
+
+  /**
+   * Address of the allocation, the same on the host and on the devices.
+   * It can be stored in other allocations,
+   * but only dereferenced on the host inside a host accessor.
+   */
+  DataType* get() const {
+    return static_cast<DataType*>(pointer);
+  }
+
+  /** Number of elements in the allocation */
+  ::size_t get_count() const {
+    return size / sizeof(DataType);
+  }
+
+  /** The kernel of the command group uses the allocation as an argument */
+  template <access::mode mode>
+  svm_pointer<DataType, mode> get_pointer(handler& cgh) {
+    add_access<mode>();
+    return svm_pointer<DataType, mode>(this);
+  }
+
+  /** The kernel of the command group reaches the allocation indirectly */
+  template <access::mode mode>
+  void require(handler& cgh) {
+    add_access<mode>();
+  }
+
+  /**
+   * Host access to the allocation,
+   * waiting for the kernels using it to complete
+   */
+  template <access::mode mode>
+  svm_host_accessor<DataType, mode> get_access() {
+    return svm_host_accessor<DataType, mode>(*this);
+  }
+};
+
+/**
+ * Host access to shared virtual memory.
+ * Commands using the allocation are held back while the accessor exists.
+ */
+template <typename DataType, access::mode mode>
+class svm_host_accessor : public detail::accessor_base {
+ private:
+  template <typename>
+  friend class svm_allocation;
+
+  using value_type =
+      typename std::conditional<mode == access::mode::read, const DataType,
+                                DataType>::type;
+
+  svm_allocation<DataType>* svm;
+
+  explicit svm_host_accessor(svm_allocation<DataType>& svm) : svm(&svm) {
+    detail::synchronizer::add(this, this->svm);
+    this->svm->map(mode == access::mode::read);
+  }
+
+ public:
+  svm_host_accessor(const svm_host_accessor&) = delete;
+  svm_host_accessor& operator=(const svm_host_accessor&) = delete;
+  svm_host_accessor(svm_host_accessor&& move) noexcept : svm(move.svm) {
+    detail::synchronizer::add(this, svm);
+    detail::synchronizer::remove(&move, svm);
+    move.svm = nullptr;
+  }
+
+  ~svm_host_accessor() {
+    if (svm != nullptr) {
+      svm->unmap();
+      detail::synchronizer::remove(this, svm);
+    }
+  }
+
+  value_type& operator[](::size_t index) const {
+    return get_pointer()[index];
+  }
+
+  value_type* get_pointer() const {
+    return svm->get();
+  }
+};
+
+}  // namespace sycl
+}  // namespace cl
+
+#endif  // CL_VERSION_2_0
@@ -0,0 +1,96 @@
+#pragma once
+
+// Memoization of traced kernels (extension)
+
+#include "SYCL/detail/common.h"
+#include "SYCL/detail/kernel_name.h"
+#include <map>
+#include <set>
+#include <tuple>
+
+namespace cl {
+namespace sycl {
+
+// Forward declaration
+class kernel;
+
+namespace detail {
+
+// Forward declaration
+struct buffer_access;
+
+/**
+ * Kernels traced and compiled by earlier submissions.
+ * A kernel is reused when the command group requests the same accessors,
+ * its buffers are bound to the buffers of the new accessors.
+ */
+class trace_memo_registry {
+ private:
+  struct entry {
+    shared_ptr_class<kernel> kern;
+    // Accessor of the command group that each kernel parameter came from
+    vector_class<::size_t> positions;
+  };
+  // Kernel type, context, compile options and accessor signature
+  using key_t = std::tuple<::size_t, cl_context, string_class, string_class>;
+
+  static std::set<::size_t> enabled;
+  static std::map<key_t, entry> entries;
+  static mutex_class m;
+
+  static string_class get_signature(const vector_class<buffer_access>& accs);
+
+ public:
+  static void enable(::size_t kernel_name_id, bool enable);
+  static bool is_enabled(::size_t kernel_name_id);
+  static void clear();
+
+  /**
+   * @return copy of the memoized kernel bound to the current command group,
+   * or the kernel returned by build, which is memoized if possible
+   */
+  static shared_ptr_class<kernel> get(
+      ::size_t kernel_type_id, cl_context ctx,
+      const string_class& compile_options,
+      const function_class<shared_ptr_class<kernel>()>& build);
+};
+
+}  // namespace detail
+
+namespace trace_memo {
+
+/**
+ * Kernels named KernelName are traced and compiled only once
+ * for each context, compile options and set of accessors,
+ * later submissions just bind the new buffers.
+ * Values the kernel captures from the host are part of the traced source,
+ * so they must not change between submissions.
+ * Kernels with local accessors are always traced.
+ */
+template <typename KernelName>
+void enable() {
+  detail::trace_memo_registry::enable(detail::kernel_name::get<KernelName>(),
+                                      true);
+}
+
+/** Traces KernelName again on every submission */
+template <typename KernelName>
+void disable() {
+  detail::trace_memo_registry::enable(detail::kernel_name::get<KernelName>(),
+                                      false);
+}
+
+/** @return true if traces of KernelName are memoized */
+template <typename KernelName>
+bool is_enabled() {
+  return detail::trace_memo_registry::is_enabled(
+      detail::kernel_name::get<KernelName>());
+}
+
+/** Releases all memoized kernels */
+void clear();
+
+}  // namespace trace_memo
+
+}  // namespace sycl
+}  // namespace cl
@@ -19,12 +19,56 @@ class vec;
 template <typename dataT, int numElements>
 using swizzled_vec = vec<dataT, numElements>;
 
+/** Rounding modes used by vector conversions */
+enum class rounding_mode { automatic, rte, rtz, rtp, rtn };
+
 namespace detail {
 namespace vectors {
 
-// Forward declaration
+// Forward declarations
 template <int, int, int...>
 struct swizzled;
+template <typename, int>
+class expression;
+
+/**
+ * Element type of the result of vector relational operators.
+ * The result has the same size as the operands, and is always signed.
+ */
+template <typename dataT>
+struct relational {
+  using type = dataT;
+};
+
+#define SYCL_VEC_RELATIONAL(from, to) \
+  template <>                         \
+  struct relational<from> {           \
+    using type = to;                  \
+  };
+
+SYCL_VEC_RELATIONAL(unsigned char, char)
+SYCL_VEC_RELATIONAL(unsigned short, short)
+SYCL_VEC_RELATIONAL(unsigned int, int)
+SYCL_VEC_RELATIONAL(unsigned long, long)
+SYCL_VEC_RELATIONAL(float, int)
+SYCL_VEC_RELATIONAL(double, long)
+
+#undef SYCL_VEC_RELATIONAL
+
+static string_class rounding_suffix(rounding_mode mode) {
+  switch (mode) {
+    case rounding_mode::rte:
+      return "_rte";
+    case rounding_mode::rtz:
+      return "_rtz";
+    case rounding_mode::rtp:
+      return "_rtp";
+    case rounding_mode::rtn:
+      return "_rtn";
+    default:
+      return "";
+  }
+}
 
 #define SYCL_ENABLE_IF_DIM(dim) \
   typename std::enable_if<num == dim>::type* = nullptr
@@ -58,6 +102,15 @@ class base : protected counter<base<dataT, numElements>>, public data_ref {
   }
 
  protected:
+  // Expressions need to be stored into a variable before being modified
+  void materialize() {
+    if (this->type == type_t::expression) {
+      base b(this->name, true);
+      this->name = std::move(b.name);
+      this->type = type_t::general;
+    }
+  }
+
   base(string_class assign, bool generate_new = false)
       : data_ref(generate_new ? generate_name() : assign) {
     if (generate_new) {
@@ -67,6 +120,7 @@ class base : protected counter<base<dataT, numElements>>, public data_ref {
 
  public:
   using element_type = dataT;
+  static const int num_elements = numElements;
   /** Underlying OpenCL type */
   using vector_t = detail::cl_type<dataT, numElements>;
 
@@ -87,9 +141,9 @@ class base : protected counter<base<dataT, numElements>>, public data_ref {
     data_ref::operator=(n);
     return *this;
   }
-  base(base&& move) noexcept : data_ref(static_cast<data_ref&&>(*this)) {}
+  base(base&& move) noexcept : data_ref(static_cast<data_ref&&>(move)) {}
   base& operator=(base&& move) noexcept {
-    data_ref::operator=(static_cast<data_ref&&>(*this));
+    data_ref::operator=(static_cast<data_ref&&>(move));
     return *this;
   }
   ~base() = default;
@@ -125,8 +179,7 @@ class base : protected counter<base<dataT, numElements>>, public data_ref {
        const data_ref& s6, const data_ref& s7, const data_ref& s8,
        const data_ref& s9, const data_ref& sA, const data_ref& sB,
        const data_ref& sC, const data_ref& sD, const data_ref& sE,
-       const data_ref& sF, const data_ref& sG, const data_ref& sH,
-       SYCL_ENABLE_IF_DIM(16))
+       const data_ref& sF, SYCL_ENABLE_IF_DIM(16))
       : base(open_parenthesis + type_name() + ")(" + s0.name + ", " + s1.name +
                  ", " + s2.name + ", " + s3.name + ", " + s4.name + ", " +
                  s5.name + ", " + s6.name + ", " + s7.name + ", " + s8.name +
@@ -159,11 +212,58 @@ class base : protected counter<base<dataT, numElements>>, public data_ref {
     return swizzled_vec<dataT, size>(this->name + ".s" + access_name);
   }
 
-  swizzled_vec<dataT, half_size> lo() const {
-    return swizzled_vec<dataT, half_size>(this->name + ".lo");
+  /**
+   * Swizzles of expressions cannot be assigned to,
+   * so non-const access stores the expression into a variable first
+   */
+  template <int... indices>
+  swizzled_vec<dataT, sizeof...(indices)> swizzle() {
+    materialize();
+    return static_cast<const base*>(this)->template swizzle<indices...>();
+  }
+
+#define SYCL_VEC_HALF_SWIZZLE(suffix)                                \
+  swizzled_vec<dataT, half_size> suffix() const {                    \
+    return swizzled_vec<dataT, half_size>(this->name + "." #suffix); \
+  }                                                                  \
+  swizzled_vec<dataT, half_size> suffix() {                          \
+    materialize();                                                   \
+    return static_cast<const base*>(this)->suffix();                 \
+  }
+
+  SYCL_VEC_HALF_SWIZZLE(lo)
+  SYCL_VEC_HALF_SWIZZLE(hi)
+  SYCL_VEC_HALF_SWIZZLE(even)
+  SYCL_VEC_HALF_SWIZZLE(odd)
+
+#undef SYCL_VEC_HALF_SWIZZLE
+
+  /** Element-wise conversion, emitted as convert_destType */
+  template <typename convertT,
+            rounding_mode roundingMode = rounding_mode::automatic>
+  expression<convertT, numElements> convert() const {
+    return expression<convertT, numElements>(
+        "convert_" + type_string<vec<convertT, numElements>>::get() +
+        rounding_suffix(roundingMode) + '(' + this->name + ')');
+  }
+
+  /** Saturated element-wise conversion, emitted as convert_destType_sat */
+  template <typename convertT,
+            rounding_mode roundingMode = rounding_mode::automatic>
+  expression<convertT, numElements> convert_sat() const {
+    return expression<convertT, numElements>(
+        "convert_" + type_string<vec<convertT, numElements>>::get() + "_sat" +
+        rounding_suffix(roundingMode) + '(' + this->name + ')');
   }
-  swizzled_vec<dataT, half_size> hi() const {
-    return swizzled_vec<dataT, half_size>(this->name + ".hi");
+
+  /** Reinterprets the vector bits as another type, emitted as as_type */
+  template <typename asT>
+  expression<typename asT::element_type, asT::num_elements> as() const {
+    static_assert(sizeof(typename base_host_data<asT>::type) ==
+                      sizeof(cl_base<dataT, numElements, numElements>),
+                  "Reinterpreted type must have the same size");
+    return expression<typename asT::element_type, asT::num_elements>(
+        "as_" + type_string<asT>::get() + '(' + this->name + ')');
   }
 
 // TODO(progtx): Swizzle methods
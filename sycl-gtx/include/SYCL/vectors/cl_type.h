@@ -1,6 +1,7 @@
 #pragma once
 
 #include "SYCL/detail/common.h"
+#include "SYCL/half.h"
 
 namespace cl {
 namespace sycl {
@@ -57,12 +58,38 @@ SYCL_ADD_CL_UVECTOR(long)
 SYCL_ADD_CL_VECTOR(float)
 SYCL_ADD_CL_VECTOR(double)
 
+/**
+ * Vectors of half values, OpenCL headers only have vectors of their bits.
+ * Same as the other vectors, 3 elements take the space of 4.
+ */
+template <int num>
+struct half_vector {
+  half s[num == 3 ? 4 : num];
+};
+
+#define SYCL_CL_HALF_VECTOR(num)   \
+  template <>                      \
+  struct cl_type<half, num> {      \
+    using type = half_vector<num>; \
+  };
+
+template <>
+struct cl_type<half, 1> {
+  using type = half;
+};
+SYCL_CL_HALF_VECTOR(2)
+SYCL_CL_HALF_VECTOR(3)
+SYCL_CL_HALF_VECTOR(4)
+SYCL_CL_HALF_VECTOR(8)
+SYCL_CL_HALF_VECTOR(16)
+
 #undef SYCL_CL_SCALAR
 #undef SYCL_CL_USCALAR
 #undef SYCL_CL_VECTOR
 #undef SYCL_CL_UVECTOR
 #undef SYCL_ADD_CL_VECTOR
 #undef SYCL_ADD_CL_UVECTOR
+#undef SYCL_CL_HALF_VECTOR
 
 }  // namespace detail
 
@@ -0,0 +1,83 @@
+#pragma once
+
+// Half precision storage in kernels (extension)
+
+#include "SYCL/accessors/device_reference.h"
+#include "SYCL/detail/common.h"
+#include "SYCL/half.h"
+#include "SYCL/vectors/cl_vec.h"
+#include "SYCL/vectors/pointer_ref.h"
+#include "SYCL/vectors/vec.h"
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+/**
+ * Buffers of half and its vectors are accessed through half pointers,
+ * which OpenCL allows even without cl_khr_fp16.
+ * Elements are loaded with _sycl_vload_halfN and stored with
+ * _sycl_vstore_halfN, defined by the kernel source as loads and stores of half
+ * on devices with cl_khr_fp16, and as vload_half and vstore_half
+ * converting from and to float on the other devices.
+ */
+template <int numElements>
+struct half_element {
+  using type = vectors::pointer_ref<half, numElements>;
+  static type get(const string_class& resource_name,
+                  const string_class& index) {
+    auto suffix =
+        (numElements == 1) ? "" : get_string<int>::get(numElements);
+    return type("_sycl_vload_half" + suffix, "_sycl_vstore_half" + suffix,
+                resource_name, index);
+  }
+};
+
+template <>
+struct pointer_type_string<half> {
+  static string_class get() {
+    return "half";
+  }
+};
+template <>
+struct acc_device_return<half> {
+  using type = half_element<1>::type;
+};
+template <>
+struct acc_device_element<half> : half_element<1> {};
+
+// Vectors of half take the space of the host vectors, 3 elements use 4
+
+template <int numElements>
+struct pointer_type_string<vec<half, numElements>>
+    : pointer_type_string<half> {};
+template <int numElements>
+struct pointer_type_string<vectors::cl_base<half, numElements, numElements>>
+    : pointer_type_string<half> {};
+
+template <int numElements>
+struct pointer_span<vec<half, numElements>> {
+  static const ::size_t value = vectors::num_elems<numElements>::value;
+};
+template <int numElements>
+struct pointer_span<vectors::cl_base<half, numElements, numElements>>
+    : pointer_span<vec<half, numElements>> {};
+
+template <int numElements>
+struct acc_device_return<vec<half, numElements>> {
+  using type = typename half_element<numElements>::type;
+};
+template <int numElements>
+struct acc_device_return<vectors::cl_base<half, numElements, numElements>>
+    : acc_device_return<vec<half, numElements>> {};
+
+template <int numElements>
+struct acc_device_element<vec<half, numElements>>
+    : half_element<numElements> {};
+template <int numElements>
+struct acc_device_element<vectors::cl_base<half, numElements, numElements>>
+    : half_element<numElements> {};
+
+}  // namespace detail
+}  // namespace sycl
+}  // namespace cl
@@ -12,6 +12,10 @@ class vec;
 
 namespace detail {
 
+// Forward declaration
+template <typename DataType>
+struct acc_device_element;
+
 // These are defined elsewhere, here only specialization for vectors
 
 template <typename dataT, int numElements>
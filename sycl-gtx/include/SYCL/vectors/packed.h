@@ -0,0 +1,91 @@
+#pragma once
+
+// Packed 3-element vectors (extension)
+
+#include "SYCL/accessors/device_reference.h"
+#include "SYCL/detail/common.h"
+#include "SYCL/detail/data_ref.h"
+#include "SYCL/vectors/cl_vec.h"
+#include "SYCL/vectors/pointer_ref.h"
+#include "SYCL/vectors/vec.h"
+
+namespace cl {
+namespace sycl {
+
+/**
+ * Buffer element of three tightly packed values.
+ * Unlike cl_float3 and the other 3-element vectors,
+ * it is not padded to the size of four elements,
+ * so a buffer of them takes a quarter less memory and transfer time.
+ * In kernels, the elements are loaded with vload3 and stored with vstore3,
+ * and behave like vec<dataT, 3>.
+ */
+template <typename dataT>
+struct packed3 {
+  dataT x;
+  dataT y;
+  dataT z;
+
+  packed3() = default;
+  packed3(dataT x, dataT y, dataT z) : x(x), y(y), z(z) {}
+  packed3(const detail::vectors::cl_base<dataT, 3, 3>& v)
+      : x(v.x()), y(v.y()), z(v.z()) {}
+
+  operator detail::vectors::cl_base<dataT, 3, 3>() const {
+    detail::vectors::cl_base<dataT, 3, 3> v;
+    v.x() = x;
+    v.y() = y;
+    v.z() = z;
+    return v;
+  }
+};
+
+namespace detail {
+
+template <typename dataT>
+struct type_string<packed3<dataT>> {
+  // Kernels access the elements through a pointer to the scalar type
+  static string_class get() {
+    return type_string<dataT>::get();
+  }
+};
+
+template <typename dataT>
+struct pointer_span<packed3<dataT>> {
+  static const ::size_t value = 3;
+};
+
+template <typename dataT>
+struct acc_device_return<packed3<dataT>> {
+  using type = vectors::pointer_ref<dataT, 3>;
+};
+
+template <typename dataT>
+struct acc_device_element<packed3<dataT>> {
+  using type = vectors::pointer_ref<dataT, 3>;
+  static type get(const string_class& resource_name,
+                  const string_class& index) {
+    return type("vload3", "vstore3", resource_name, index);
+  }
+};
+
+}  // namespace detail
+
+#define SYCL_PACKED_VECTOR(base) using packed_##base##3 = packed3<base>;
+
+#define SYCL_PACKED_UVECTOR(base) \
+  SYCL_PACKED_VECTOR(base)        \
+  using packed_u##base##3 = packed3<unsigned base>;
+
+SYCL_PACKED_UVECTOR(int)
+SYCL_PACKED_UVECTOR(char)
+SYCL_PACKED_UVECTOR(short)
+SYCL_PACKED_UVECTOR(long)
+SYCL_PACKED_VECTOR(float)
+SYCL_PACKED_VECTOR(double)
+
+#undef SYCL_PACKED_VECTOR
+#undef SYCL_PACKED_UVECTOR
+
+}  // namespace sycl
+}  // namespace cl
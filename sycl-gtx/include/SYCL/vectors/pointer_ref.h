@@ -0,0 +1,97 @@
+#pragma once
+
+#include "SYCL/detail/common.h"
+#include "SYCL/detail/data_ref.h"
+#include "SYCL/vectors/vec.h"
+
+namespace cl {
+namespace sycl {
+namespace detail {
+
+// Forward declarations
+template <typename DataType>
+struct acc_device_element;
+template <int numElements>
+struct half_element;
+
+namespace vectors {
+
+/**
+ * Buffer element in kernel source
+ * that is loaded and stored through functions, such as vload3 and vstore3.
+ * Reading it loads the element, assigning to it stores the whole element.
+ * Assignments to single components, like acc[i].x() = 0,
+ * are not supported and fail to compile on the device.
+ */
+template <typename dataT, int numElements>
+class pointer_ref : public expression<dataT, numElements> {
+ private:
+  template <typename>
+  friend struct ::cl::sycl::detail::acc_device_element;
+  template <int>
+  friend struct ::cl::sycl::detail::half_element;
+
+  string_class store_function;
+  string_class pointer;
+  string_class index;
+
+  pointer_ref(const string_class& load_function, string_class store_function,
+              string_class pointer, string_class index)
+      : expression<dataT, numElements>(load_function + '(' + index + ", " +
+                                       pointer + ')'),
+        store_function(std::move(store_function)),
+        pointer(std::move(pointer)),
+        index(std::move(index)) {}
+
+  void store(const string_class& value) {
+    kernel_add(store_function + '(' + value + ", " + index + ", " + pointer +
+               ')');
+  }
+
+ public:
+  // Copies refer to the same element
+  pointer_ref(const pointer_ref& copy)
+      : expression<dataT, numElements>(copy.name),
+        store_function(copy.store_function),
+        pointer(copy.pointer),
+        index(copy.index) {}
+
+  pointer_ref& operator=(const pointer_ref& copy) {
+    store(copy.name);
+    return *this;
+  }
+  pointer_ref& operator=(const data_ref& copy) {
+    store(copy.name);
+    return *this;
+  }
+  pointer_ref& operator=(const dataT& n) {
+    store(data_ref::open_parenthesis +
+          type_string<vec<dataT, numElements>>::get() + ")(" +
+          get_string<dataT>::get(n) + ')');
+    return *this;
+  }
+
+#define SYCL_POINTER_ASSIGNMENT_OP(op)      \
+  template <class T>                        \
+  pointer_ref& operator op##=(const T& n) { \
+    return *this = *this op n;              \
+  }
+
+  SYCL_POINTER_ASSIGNMENT_OP(+)
+  SYCL_POINTER_ASSIGNMENT_OP(-)
+  SYCL_POINTER_ASSIGNMENT_OP(*)
+  SYCL_POINTER_ASSIGNMENT_OP(/)
+  SYCL_POINTER_ASSIGNMENT_OP(%)
+  SYCL_POINTER_ASSIGNMENT_OP(&)
+  SYCL_POINTER_ASSIGNMENT_OP(|)
+  SYCL_POINTER_ASSIGNMENT_OP(^)
+  SYCL_POINTER_ASSIGNMENT_OP(>>)
+  SYCL_POINTER_ASSIGNMENT_OP(<<)
+
+#undef SYCL_POINTER_ASSIGNMENT_OP
+};
+
+}  // namespace vectors
+}  // namespace detail
+}  // namespace sycl
+}  // namespace cl
@@ -9,9 +9,11 @@ namespace sycl {
 namespace detail {
 namespace vectors {
 
+/** OpenCL uses hexadecimal digits to access elements s0 to sF */
 template <int index, int current>
 static void to_char(char* name) {
-  name[index] = static_cast<char>(current) + '0';
+  name[index] = static_cast<char>(current < 10 ? current + '0'
+                                                : current - 10 + 'A');
 }
 
 template <int index, int current, int... others>
@@ -23,8 +23,14 @@ class vec : public detail::vectors::base<dataT, numElements>,
   friend class detail::accessor_detail;
   template <int, typename, int, access::mode, access::target>
   friend class detail::accessor_device_ref;
+  template <typename>
+  friend struct detail::acc_device_element;
   template <typename, int>
   friend class detail::vectors::base;
+  template <typename, int>
+  friend class vec;
+  template <typename, int>
+  friend class detail::vectors::expression;
 
   using Base = detail::vectors::base<dataT, numElements>;
   using Members = detail::vectors::members<dataT, numElements>;
@@ -32,17 +38,13 @@ class vec : public detail::vectors::base<dataT, numElements>,
   using genvector = detail::vectors::cl_base<dataT, numElements, numElements>;
   using data_ref = detail::data_ref;
   using type_t = data_ref::type_t;
-
-  // Helper constructor to help with assignment
-  vec(const string_class& name, bool, bool) : Base(name, true), Members(this) {}
+  using expression_t = detail::vectors::expression<dataT, numElements>;
+  using relational_t = detail::vectors::expression<
+      typename detail::vectors::relational<dataT>::type, numElements>;
 
   template <typename T>
   void assign(const T& copy) {
-    if (this->type == type_t::expression) {
-      vec b(this->name, true, true);
-      this->name = std::move(b.name);
-      this->type = type_t::general;
-    }
+    this->materialize();
     Base::operator=(copy);
   }
 
@@ -55,9 +57,10 @@ class vec : public detail::vectors::base<dataT, numElements>,
   vec() : Base(), Members(this) {}
   vec(const vec& copy) : Base(copy.name, true), Members(this) {}
   vec(const data_ref& copy) : Base(copy.name, true), Members(this) {}
-  vec(vec&& move) noexcept : Base(std::move(move.name)), Members(this) {
-    this->type = move.type;
-  }
+  /** Expressions are stored into a new variable */
+  vec(vec&& move) noexcept
+      : Base(std::move(move.name), move.type == type_t::expression),
+        Members(this) {}
   vec(data_ref&& move) : Base(std::move(move.name), true), Members(this) {}
   ~vec() = default;
 
@@ -97,7 +100,7 @@ class vec : public detail::vectors::base<dataT, numElements>,
   vec(const data_ref& s0, const data_ref& s1, const data_ref& s2,
       const data_ref& s3, const data_ref& s4, const data_ref& s5,
       const data_ref& s6, const data_ref& s7, SYCL_ENABLE_IF_DIM(8))
-      : Base(s1, s2, s3, s4, s5, s6, s7), Members(this) {}
+      : Base(s0, s1, s2, s3, s4, s5, s6, s7), Members(this) {}
   template <int num = numElements>
   vec(const data_ref& s0, const data_ref& s1, const data_ref& s2,
       const data_ref& s3, const data_ref& s4, const data_ref& s5,
@@ -105,7 +108,7 @@ class vec : public detail::vectors::base<dataT, numElements>,
       const data_ref& s9, const data_ref& sA, const data_ref& sB,
       const data_ref& sC, const data_ref& sD, const data_ref& sE,
       const data_ref& sF, SYCL_ENABLE_IF_DIM(16))
-      : Base(s1, s2, s3, s4, s5, s6, s7, s8, s9, sA, sB, sC, sD, sE, sF),
+      : Base(s0, s1, s2, s3, s4, s5, s6, s7, s8, s9, sA, sB, sC, sD, sE, sF),
         Members(this) {}
 
   // TODO(progtx):
@@ -113,22 +116,86 @@ class vec : public detail::vectors::base<dataT, numElements>,
     return genvector();
   }
 
-// TODO(progtx): Operators
-#define SYCL_VEC_OP(op)                                \
-  vec operator op(const vec& v) const {                \
-    auto r = data_ref::operator op(v);                 \
-    return vec(std::move(r.name), type_t::expression); \
-  }                                                    \
-  vec operator op(const data_ref& d) const {           \
-    auto r = data_ref::operator op(d);                 \
-    return vec(std::move(r.name), type_t::expression); \
+#define SYCL_VEC_OP(op)                                                      \
+  expression_t operator op(const vec& v) const {                             \
+    return expression_t(data_ref::operator op(v).name);                      \
+  }                                                                          \
+  expression_t operator op(const data_ref& d) const {                        \
+    return expression_t(data_ref::operator op(d).name);                      \
+  }                                                                          \
+  friend expression_t operator op(const dataT& n, const vec& v) {            \
+    return expression_t(data_ref::open_parenthesis + data_ref::get_name(n) + \
+                        " " #op " " + v.name + ')');                         \
+  }
+
+// Relational operators return a signed vector of the same size
+#define SYCL_VEC_RELATIONAL_OP(op)                      \
+  relational_t operator op(const vec& v) const {        \
+    return relational_t(data_ref::operator op(v).name); \
+  }                                                     \
+  relational_t operator op(const data_ref& d) const {   \
+    return relational_t(data_ref::operator op(d).name); \
   }
 
+#define SYCL_VEC_ASSIGNMENT_OP(op) \
+  template <class T>               \
+  vec& operator op(const T& n) {   \
+    this->materialize();           \
+    data_ref::operator op(n);      \
+    return *this;                  \
+  }
+
+  // Arithmetic operators
   SYCL_VEC_OP(+)
+  SYCL_VEC_ASSIGNMENT_OP(+=)
   SYCL_VEC_OP(-)
+  SYCL_VEC_ASSIGNMENT_OP(-=)
   SYCL_VEC_OP(*)
+  SYCL_VEC_ASSIGNMENT_OP(*=)
+  SYCL_VEC_OP(/)
+  SYCL_VEC_ASSIGNMENT_OP(/=)
+  SYCL_VEC_OP(%)
+  SYCL_VEC_ASSIGNMENT_OP(%=)
+
+  // Bit operators
+  SYCL_VEC_OP(&)
+  SYCL_VEC_ASSIGNMENT_OP(&=)
+  SYCL_VEC_OP(|)
+  SYCL_VEC_ASSIGNMENT_OP(|=)
+  SYCL_VEC_OP (^)
+  SYCL_VEC_ASSIGNMENT_OP(^=)
+
+  // Shifts
+  SYCL_VEC_OP(>>)
+  SYCL_VEC_ASSIGNMENT_OP(>>=)
+  SYCL_VEC_OP(<<)
+  SYCL_VEC_ASSIGNMENT_OP(<<=)
+
+  // Comparison operators
+  SYCL_VEC_RELATIONAL_OP(==)
+  SYCL_VEC_RELATIONAL_OP(!=)
+  SYCL_VEC_RELATIONAL_OP(<)
+  SYCL_VEC_RELATIONAL_OP(<=)
+  SYCL_VEC_RELATIONAL_OP(>)
+  SYCL_VEC_RELATIONAL_OP(>=)
+
+  // Boolean operators
+  SYCL_VEC_RELATIONAL_OP(||)
+  SYCL_VEC_RELATIONAL_OP(&&)
 
 #undef SYCL_VEC_OP
+#undef SYCL_VEC_RELATIONAL_OP
+#undef SYCL_VEC_ASSIGNMENT_OP
+
+  expression_t operator-() const {
+    return expression_t(data_ref::open_parenthesis + '-' + this->name + ')');
+  }
+  expression_t operator~() const {
+    return expression_t(data_ref::open_parenthesis + '~' + this->name + ')');
+  }
+  relational_t operator!() const {
+    return relational_t(data_ref::open_parenthesis + '!' + this->name + ')');
+  }
 };
 
 template <typename dataT>
@@ -139,8 +206,14 @@ class vec<dataT, 1> : public detail::vectors::base<dataT, 1>,
   friend class detail::accessor_detail;
   template <int, typename, int, access::mode, access::target>
   friend class detail::accessor_device_ref;
+  template <typename>
+  friend struct detail::acc_device_element;
   template <typename, int>
   friend class detail::vectors::base;
+  template <typename, int>
+  friend class vec;
+  template <typename, int>
+  friend class detail::vectors::expression;
 
   using Base = detail::vectors::base<dataT, 1>;
   using Members = detail::vectors::members<dataT, 1>;
@@ -148,17 +221,11 @@ class vec<dataT, 1> : public detail::vectors::base<dataT, 1>,
   using genvector = detail::vectors::cl_base<dataT, 1, 1>;
   using data_ref = detail::data_ref;
   using type_t = data_ref::type_t;
-
-  // Helper constructor to help with assignment
-  vec(const string_class& name, bool, bool) : Base(name, true), Members(this) {}
+  using expression_t = detail::vectors::expression<dataT, 1>;
 
   template <typename T>
   vec& assign(const T& copy) {
-    if (this->type == type_t::expression) {
-      vec b(this->name, true, true);
-      this->name = std::move(b.name);
-      this->type = type_t::general;
-    }
+    this->materialize();
     Base::operator=(copy);
     return *this;
   }
@@ -172,9 +239,10 @@ class vec<dataT, 1> : public detail::vectors::base<dataT, 1>,
   vec() : Base(), Members(this) {}
   vec(const vec& copy) : Base(copy.name, true), Members(this) {}
   vec(const data_ref& copy) : Base(copy.name, true), Members(this) {}
-  vec(vec&& move) noexcept : Base(std::move(move.name)), Members(this) {
-    this->type = move.type;
-  }
+  /** Expressions are stored into a new variable */
+  vec(vec&& move) noexcept
+      : Base(std::move(move.name), move.type == type_t::expression),
+        Members(this) {}
   vec(data_ref&& move) : Base(std::move(move.name), true), Members(this) {}
   ~vec() = default;
 
@@ -207,21 +275,57 @@ class vec<dataT, 1> : public detail::vectors::base<dataT, 1>,
     return genvector();
   }
 
-// TODO(progtx): Operators
-#define SYCL_VEC_OP(op)                                \
-  vec operator op(const data_ref& d) const {           \
-    auto r = data_ref::operator op(d);                 \
-    return vec(std::move(r.name), type_t::expression); \
+#define SYCL_VEC_OP(op)                                 \
+  expression_t operator op(const data_ref& d) const {   \
+    return expression_t(data_ref::operator op(d).name); \
+  }
+
+#define SYCL_VEC_ASSIGNMENT_OP(op) \
+  template <class T>               \
+  vec& operator op(const T& n) {   \
+    this->materialize();           \
+    data_ref::operator op(n);      \
+    return *this;                  \
   }
 
   SYCL_VEC_OP(+);
+  SYCL_VEC_ASSIGNMENT_OP(+=);
   SYCL_VEC_OP(-);
+  SYCL_VEC_ASSIGNMENT_OP(-=);
   SYCL_VEC_OP(*);
+  SYCL_VEC_ASSIGNMENT_OP(*=);
   SYCL_VEC_OP(/);
+  SYCL_VEC_ASSIGNMENT_OP(/=);
+  SYCL_VEC_OP(%);
+  SYCL_VEC_ASSIGNMENT_OP(%=);
 
 #undef SYCL_VEC_OP
+#undef SYCL_VEC_ASSIGNMENT_OP
+
+  expression_t operator-() const {
+    return expression_t(data_ref::open_parenthesis + '-' + this->name + ')');
+  }
 };
 
+namespace detail {
+namespace vectors {
+
+/**
+ * Result of an operation on vectors.
+ * Used as an operand it stays an expression in the kernel source,
+ * but stored into a vector it becomes a new variable.
+ */
+template <typename dataT, int numElements>
+class expression : public vec<dataT, numElements> {
+ public:
+  explicit expression(string_class name)
+      : vec<dataT, numElements>(std::move(name), data_ref::type_t::expression) {
+  }
+};
+
+}  // namespace vectors
+}  // namespace detail
+
 // 3.10.1 Description of the built-in types available for SYCL host and device
 
 #define SYCL_VEC_SCALAR(base)   \
@@ -265,6 +369,7 @@ SYCL_ADD_VEC_UVECTOR(short)
 SYCL_ADD_VEC_UVECTOR(long)
 SYCL_ADD_VEC_VECTOR(float)
 SYCL_ADD_VEC_VECTOR(double)
+SYCL_ADD_VEC_VECTOR(half)
 
 #undef SYCL_VEC_SCALAR
 #undef SYCL_VEC_USCALAR
@@ -44,6 +44,10 @@ struct members<dataT, parentElems, 2> : members<dataT, parentElems, 1> {
   swizzled_vec<dataT, 1> y() const {
     return this->parent->template swizzle<1>();
   }
+
+  swizzled_vec<dataT, 2> xy() const {
+    return this->parent->template swizzle<0, 1>();
+  }
 #endif
 };
 
@@ -72,6 +76,10 @@ struct members<dataT, parentElems, 4> : members<dataT, parentElems, 3> {
   swizzled_vec<dataT, 1> w() const {
     return this->parent->template swizzle<3>();
   }
+
+  swizzled_vec<dataT, 4> xyzw() const {
+    return this->parent->template swizzle<0, 1, 2, 3>();
+  }
 #endif
 };
 
@@ -1,6 +1,8 @@
 #include "SYCL/buffer_base.h"
 
 #include "SYCL/queue.h"
+#include <cstdio>
+#include <fstream>
 
 using namespace cl::sycl;
 using namespace detail;
@@ -8,19 +10,107 @@ using namespace detail;
 ::cl_int buffer_base::cl_enqueue_buffer(
     queue* q, ::size_t size, void* host_ptr,
     const vector_class<cl_event>& wait_events, cl_event& evnt,
-    clEnqueueBuffer_f clEnqueueBuffer) {
+    clEnqueueBuffer_f clEnqueueBuffer, bool is_blocking) {
+  auto copy_q = q->get_copy_queue();
+
+  if (!is_host_pinned && size > 0) {
+    auto staging = memory_pool::get_staging(q->get_context(), copy_q);
+    if (staging != nullptr) {
+      if (clEnqueueBuffer == &clEnqueueWriteBuffer) {
+        return staging->write(copy_q, device_data.get(), is_blocking, size,
+                              host_ptr, wait_events, evnt);
+      }
+      return staging->read(copy_q, device_data.get(), is_blocking, size,
+                           host_ptr, wait_events, evnt);
+    }
+  }
+
   auto num_events_to_wait = wait_events.size();
 
   return clEnqueueBuffer(
-      q->get(), device_data.get(), false,
+      copy_q, device_data.get(), is_blocking,
       // TODO(progtx): Sub-buffer access
       0, size, host_ptr, static_cast<::cl_uint>(num_events_to_wait),
       (num_events_to_wait == 0 ? nullptr : wait_events.data()), &evnt);
 }
 
+::cl_int buffer_base::cl_enqueue_image(
+    queue* q, const ::size_t* region, void* host_ptr,
+    const vector_class<cl_event>& wait_events, cl_event& evnt,
+    clEnqueueBuffer_f clEnqueueBuffer) {
+  static const ::size_t origin[3] = {0, 0, 0};
+  auto num_events_to_wait = static_cast<::cl_uint>(wait_events.size());
+  auto wait_list = (num_events_to_wait == 0 ? nullptr : wait_events.data());
+
+  // Pixels are tightly packed, the pitches are computed from the format
+  if (clEnqueueBuffer == &clEnqueueWriteBuffer) {
+    return clEnqueueWriteImage(q->get_copy_queue(), device_data.get(), false,
+                               origin, region, 0, 0, host_ptr,
+                               num_events_to_wait, wait_list, &evnt);
+  }
+  return clEnqueueReadImage(q->get_copy_queue(), device_data.get(), false,
+                            origin, region, 0, 0, host_ptr, num_events_to_wait,
+                            wait_list, &evnt);
+}
+
 cl_mem buffer_base::cl_create_buffer(queue* q, const cl_mem_flags& flags,
                                      ::size_t size, void* host_ptr,
                                      ::cl_int& error_code) {
   return clCreateBuffer(q->get_context().get(), flags, size, host_ptr,
                         &error_code);
 }
+
+cl_mem buffer_base::cl_create_image(queue* q, const cl_mem_flags& flags,
+                                    const cl_image_format& format,
+                                    const cl_image_desc& desc,
+                                    ::cl_int& error_code) {
+  return clCreateImage(q->get_context().get(), flags, &format, &desc, nullptr,
+                       &error_code);
+}
+
+cl_mem buffer_base::cl_create_sub_buffer(cl_mem parent, ::size_t origin,
+                                         ::size_t size, ::cl_int& error_code) {
+  // Flags are inherited from the parent
+  cl_buffer_region region = {origin, size};
+  return clCreateSubBuffer(parent, 0, CL_BUFFER_CREATE_TYPE_REGION, &region,
+                           &error_code);
+}
+
+mem_ref buffer_base::pool_create_buffer(queue* q, const cl_mem_flags& flags,
+                                        ::size_t size) {
+  return memory_pool::acquire(q->get_context(), flags, size);
+}
+
+shared_ptr_class<void> buffer_base::pool_create_host(queue* q, ::size_t size) {
+  auto ctx = q->get_context();
+  if (!memory_pool::is_pinned(ctx)) {
+    return nullptr;
+  }
+  return memory_pool::acquire_host(ctx, q->get(), size);
+}
+
+bool buffer_base::write_file(const string_class& path, const void* data,
+                             ::size_t size) {
+  // The data can be a mapping of the file itself,
+  // which truncating the file would invalidate
+  auto temporary = path + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file.write(static_cast<const char*>(data),
+               static_cast<std::streamsize>(size));
+    if (!file) {
+      file.close();
+      std::remove(temporary.c_str());
+      return false;
+    }
+  }
+#ifdef _WIN32
+  // Doesn't replace existing files
+  std::remove(path.c_str());
+#endif
+  if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+    std::remove(temporary.c_str());
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,450 @@
+#include "SYCL/buffer_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+using namespace cl::sycl;
+using namespace detail;
+
+void buffer_pool::set_limit(const context& ctx, ::size_t max_cached_bytes) {
+  memory_pool::set_limit(ctx, max_cached_bytes);
+}
+
+buffer_pool::stats buffer_pool::get_stats(const context& ctx) {
+  return memory_pool::get_stats(ctx);
+}
+
+void buffer_pool::trim(const context& ctx) {
+  memory_pool::trim(ctx);
+}
+
+void buffer_pool::set_pinned_host(const context& ctx, bool enable) {
+  memory_pool::set_pinned(ctx, enable);
+}
+
+bool buffer_pool::is_pinned_host(const context& ctx) {
+  return memory_pool::is_pinned(ctx);
+}
+
+static void* map_pinned(cl_command_queue q, cl_mem mem, ::size_t size) {
+  ::cl_int error_code;
+  auto host_ptr =
+      clEnqueueMapBuffer(q, mem, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0, size,
+                         0, nullptr, nullptr, &error_code);
+  error::report(error_code);
+  return host_ptr;
+}
+
+static void unmap_pinned(cl_command_queue q, cl_mem mem, void* host_ptr) {
+  auto error_code =
+      clEnqueueUnmapMemObject(q, mem, host_ptr, 0, nullptr, nullptr);
+  error::report(error_code);
+  error_code = clFinish(q);
+  error::report(error_code);
+}
+
+const ::size_t staging_ring::chunk_size;
+const int staging_ring::num_chunks;
+
+staging_ring::staging_ring(cl_context ctx, cl_command_queue q) : map_q(q) {
+  auto error_code = clRetainCommandQueue(map_q);
+  error::report(error_code);
+
+  chunks.reserve(num_chunks);
+  for (int i = 0; i < num_chunks; ++i) {
+    auto mem = clCreateBuffer(ctx, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR,
+                              chunk_size, nullptr, &error_code);
+    error::report(error_code);
+    chunks.push_back({mem, map_pinned(map_q, mem, chunk_size), nullptr});
+  }
+}
+
+staging_ring::~staging_ring() {
+  for (auto& c : chunks) {
+    if (c.in_use != nullptr) {
+      clWaitForEvents(1, &c.in_use);
+      clReleaseEvent(c.in_use);
+    }
+    unmap_pinned(map_q, c.mem, c.host_ptr);
+    clReleaseMemObject(c.mem);
+  }
+  clReleaseCommandQueue(map_q);
+}
+
+staging_ring::chunk& staging_ring::acquire() {
+  auto& c = chunks[next];
+  next = (next + 1) % chunks.size();
+  if (c.in_use != nullptr) {
+    auto error_code = clWaitForEvents(1, &c.in_use);
+    error::report(error_code);
+    clReleaseEvent(c.in_use);
+    c.in_use = nullptr;
+  }
+  return c;
+}
+
+namespace {
+
+// Chunks have to be copied to user memory after each read completes,
+// the whole read is signaled once all of them are copied
+struct staged_read {
+  std::atomic<int> remaining;
+  cl_event done;
+};
+
+struct staged_chunk {
+  staged_read* read;
+  void* dst;
+  const void* src;
+  ::size_t size;
+  cl_event copied;
+};
+
+// Copies user memory into a chunk once the commands writing it completed
+struct staged_fill {
+  void* dst;
+  const void* src;
+  ::size_t size;
+  cl_event filled;
+};
+
+void CL_CALLBACK fill_staged_chunk(cl_event evnt, ::cl_int status,
+                                   void* user_data) {
+  auto f = static_cast<staged_fill*>(user_data);
+  if (status == CL_COMPLETE) {
+    std::memcpy(f->dst, f->src, f->size);
+  }
+  clSetUserEventStatus(f->filled, status);
+  clReleaseEvent(f->filled);
+  delete f;
+}
+
+void CL_CALLBACK copy_staged_chunk(cl_event evnt, ::cl_int status,
+                                   void* user_data) {
+  auto c = static_cast<staged_chunk*>(user_data);
+  if (status == CL_COMPLETE) {
+    std::memcpy(c->dst, c->src, c->size);
+  }
+  clSetUserEventStatus(c->copied, status);
+  clReleaseEvent(c->copied);
+
+  auto read = c->read;
+  if (--read->remaining == 0) {
+    clSetUserEventStatus(read->done, status);
+    clReleaseEvent(read->done);
+    delete read;
+  }
+  delete c;
+}
+
+}  // namespace
+
+::cl_int staging_ring::write(cl_command_queue q, cl_mem mem, bool is_blocking,
+                             ::size_t size, const void* host_ptr,
+                             const vector_class<cl_event>& wait_events,
+                             cl_event& evnt) {
+  std::lock_guard<mutex_class> lock(m);
+  auto src = static_cast<const char*>(host_ptr);
+  ::cl_int error_code;
+
+  // Completes once the user memory holds the data to write
+  cl_event ready = nullptr;
+  cl_context ctx = nullptr;
+  if (!wait_events.empty()) {
+    error_code = clGetCommandQueueInfo(q, CL_QUEUE_CONTEXT, sizeof(ctx), &ctx,
+                                       nullptr);
+    if (error_code != CL_SUCCESS) {
+      return error_code;
+    }
+    error_code = clEnqueueMarkerWithWaitList(
+        q, static_cast<::cl_uint>(wait_events.size()), wait_events.data(),
+        &ready);
+    if (error_code != CL_SUCCESS) {
+      return error_code;
+    }
+  }
+
+  for (::size_t offset = 0; offset < size; offset += chunk_size) {
+    auto& c = acquire();
+    auto n = std::min(chunk_size, size - offset);
+
+    cl_event filled = nullptr;
+    if (ready == nullptr) {
+      std::memcpy(c.host_ptr, src + offset, n);
+    } else {
+      filled = clCreateUserEvent(ctx, &error_code);
+      error::report(error_code);
+      // One reference is released by the callback
+      clRetainEvent(filled);
+      error_code = clSetEventCallback(
+          ready, CL_COMPLETE, fill_staged_chunk,
+          new staged_fill{c.host_ptr, src + offset, n, filled});
+      error::report(error_code);
+    }
+
+    // Each write waits for its chunk to be filled
+    error_code = clEnqueueWriteBuffer(q, mem, false, offset, n, c.host_ptr,
+                                      (filled == nullptr ? 0 : 1),
+                                      (filled == nullptr ? nullptr : &filled),
+                                      &c.in_use);
+    if (filled != nullptr) {
+      clReleaseEvent(filled);
+    }
+    if (error_code != CL_SUCCESS) {
+      if (ready != nullptr) {
+        clReleaseEvent(ready);
+      }
+      return error_code;
+    }
+    // Waiting on a user event doesn't flush the queue
+    clFlush(q);
+  }
+  if (ready != nullptr) {
+    clReleaseEvent(ready);
+  }
+
+  // The last write completes after all previous ones
+  evnt = chunks[(next + chunks.size() - 1) % chunks.size()].in_use;
+  error_code = clRetainEvent(evnt);
+  if (error_code == CL_SUCCESS && is_blocking) {
+    error_code = clWaitForEvents(1, &evnt);
+  }
+  return error_code;
+}
+
+
+::cl_int staging_ring::read(cl_command_queue q, cl_mem mem, bool is_blocking,
+                            ::size_t size, void* host_ptr,
+                            const vector_class<cl_event>& wait_events,
+                            cl_event& evnt) {
+  std::lock_guard<mutex_class> lock(m);
+  auto dst = static_cast<char*>(host_ptr);
+  auto num_events_to_wait = static_cast<::cl_uint>(wait_events.size());
+
+  cl_context ctx;
+  auto error_code = clGetCommandQueueInfo(q, CL_QUEUE_CONTEXT, sizeof(ctx),
+                                          &ctx, nullptr);
+  if (error_code != CL_SUCCESS) {
+    return error_code;
+  }
+
+  auto read = new staged_read;
+  read->remaining = static_cast<int>((size + chunk_size - 1) / chunk_size);
+  read->done = clCreateUserEvent(ctx, &error_code);
+  if (error_code != CL_SUCCESS) {
+    delete read;
+    return error_code;
+  }
+  // One reference is released by the last callback
+  evnt = read->done;
+  clRetainEvent(evnt);
+
+  for (::size_t offset = 0; offset < size; offset += chunk_size) {
+    auto& c = acquire();
+    auto n = std::min(chunk_size, size - offset);
+
+    cl_event read_event;
+    error_code = clEnqueueReadBuffer(
+        q, mem, false, offset, n, c.host_ptr, num_events_to_wait,
+        (num_events_to_wait == 0 ? nullptr : wait_events.data()), &read_event);
+    if (error_code != CL_SUCCESS) {
+      // Remaining chunks will never be copied
+      auto missing = static_cast<int>((size - offset + chunk_size - 1) /
+                                      chunk_size);
+      if ((read->remaining -= missing) == 0) {
+        clSetUserEventStatus(read->done, error_code);
+        clReleaseEvent(read->done);
+        delete read;
+      }
+      return error_code;
+    }
+
+    c.in_use = clCreateUserEvent(ctx, &error_code);
+    error::report(error_code);
+    clRetainEvent(c.in_use);
+    error_code = clSetEventCallback(
+        read_event, CL_COMPLETE, copy_staged_chunk,
+        new staged_chunk{read, dst + offset, c.host_ptr, n, c.in_use});
+    error::report(error_code);
+    clReleaseEvent(read_event);
+    num_events_to_wait = 0;
+
+    // Waiting on a user event doesn't flush the queue
+    clFlush(q);
+  }
+
+  if (is_blocking) {
+    return clWaitForEvents(1, &evnt);
+  }
+  return CL_SUCCESS;
+}
+
+std::map<cl_context, weak_ptr_class<context_pool>> memory_pool::pools;
+mutex_class memory_pool::m;
+
+context_pool::~context_pool() {
+  trim(0);
+}
+
+void context_pool::trim(::size_t max_cached_bytes) {
+  while (s.bytes_cached > max_cached_bytes) {
+    auto it = --released.end();
+    auto& p = it->second;
+    s.bytes_cached -= it->first.second;
+    if (p.host_ptr != nullptr) {
+      unmap_pinned(p.map_q, p.mem, p.host_ptr);
+      clReleaseCommandQueue(p.map_q);
+    }
+    mem_ref::call_release(p.mem);
+    released.erase(it);
+  }
+}
+
+context_pool::pooled context_pool::take(key_t key) {
+  pooled p{nullptr, nullptr, nullptr};
+
+  {
+    std::lock_guard<mutex_class> lock(m);
+    auto it = released.find(key);
+    if (it != released.end()) {
+      p = it->second;
+      released.erase(it);
+      s.bytes_cached -= key.second;
+      ++s.reuses;
+    } else {
+      ++s.allocations;
+      s.peak_bytes =
+          std::max(s.peak_bytes, s.bytes_in_use + s.bytes_cached + key.second);
+    }
+    s.bytes_in_use += key.second;
+  }
+
+  if (p.mem == nullptr) {
+    ::cl_int error_code;
+    p.mem = clCreateBuffer(ctx, key.first, key.second, nullptr, &error_code);
+    if (error_code != CL_SUCCESS) {
+      std::lock_guard<mutex_class> lock(m);
+      --s.allocations;
+      s.bytes_in_use -= key.second;
+    }
+    error::report(error_code);
+  }
+
+  return p;
+}
+
+void context_pool::release(key_t key, pooled p) {
+  std::lock_guard<mutex_class> lock(m);
+  s.bytes_in_use -= key.second;
+  released.emplace(key, p);
+  s.bytes_cached += key.second;
+  trim(limit);
+}
+
+shared_ptr_class<context_pool> memory_pool::attach(cl_context ctx) {
+  std::lock_guard<mutex_class> lock(m);
+  // A released context handle can be reused by a new context
+  for (auto it = pools.begin(); it != pools.end();) {
+    if (it->second.expired()) {
+      it = pools.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  auto& entry = pools[ctx];
+  auto pool = entry.lock();
+  if (pool == nullptr) {
+    pool = std::make_shared<context_pool>(ctx);
+    entry = pool;
+  }
+  return pool;
+}
+
+::size_t memory_pool::size_class(::size_t size) {
+  static const ::size_t min_size = 256;
+  if (size <= min_size) {
+    return min_size;
+  }
+
+  // Four classes between consecutive powers of two,
+  // so at most a quarter of the memory object is wasted
+  ::size_t power = min_size;
+  while (power * 2 <= size) {
+    power *= 2;
+  }
+  auto step = power / 4;
+  return (size + step - 1) / step * step;
+}
+
+mem_ref memory_pool::acquire(const context& ctx, cl_mem_flags flags,
+                             ::size_t size) {
+  context_pool::key_t key(flags, size_class(size));
+  auto pool = ctx.pool;
+  auto p = pool->take(key);
+  return mem_ref(p.mem, [pool, key, p](cl_mem released) {
+    pool->release(key, p);
+  });
+}
+
+shared_ptr_class<void> memory_pool::acquire_host(const context& ctx,
+                                                 cl_command_queue q,
+                                                 ::size_t size) {
+  context_pool::key_t key(CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR,
+                          size_class(size));
+  auto pool = ctx.pool;
+  auto p = pool->take(key);
+  if (p.host_ptr == nullptr) {
+    p.host_ptr = map_pinned(q, p.mem, key.second);
+    p.map_q = q;
+    clRetainCommandQueue(q);
+  }
+  return shared_ptr_class<void>(p.host_ptr, [pool, key, p](void* released) {
+    pool->release(key, p);
+  });
+}
+
+shared_ptr_class<staging_ring> memory_pool::get_staging(const context& ctx,
+                                                        cl_command_queue q) {
+  auto& pool = *ctx.pool;
+  std::lock_guard<mutex_class> lock(pool.m);
+  if (pool.pinned && pool.staging == nullptr) {
+    pool.staging = std::make_shared<staging_ring>(pool.ctx, q);
+  }
+  return pool.staging;
+}
+
+void memory_pool::set_pinned(const context& ctx, bool enable) {
+  auto& pool = *ctx.pool;
+  std::lock_guard<mutex_class> lock(pool.m);
+  pool.pinned = enable;
+  if (!enable) {
+    pool.staging.reset();
+  }
+}
+
+bool memory_pool::is_pinned(const context& ctx) {
+  auto& pool = *ctx.pool;
+  std::lock_guard<mutex_class> lock(pool.m);
+  return pool.pinned;
+}
+
+void memory_pool::set_limit(const context& ctx, ::size_t max_cached_bytes) {
+  auto& pool = *ctx.pool;
+  std::lock_guard<mutex_class> lock(pool.m);
+  pool.limit = max_cached_bytes;
+  pool.trim(pool.limit);
+}
+
+buffer_pool::stats memory_pool::get_stats(const context& ctx) {
+  auto& pool = *ctx.pool;
+  std::lock_guard<mutex_class> lock(pool.m);
+  return pool.s;
+}
+
+void memory_pool::trim(const context& ctx) {
+  auto& pool = *ctx.pool;
+  std::lock_guard<mutex_class> lock(pool.m);
+  pool.trim(0);
+}
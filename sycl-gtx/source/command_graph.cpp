@@ -0,0 +1,96 @@
+#include "SYCL/command_graph.h"
+
+#include "SYCL/kernel.h"
+#include <algorithm>
+
+using namespace cl::sycl;
+using detail::command::type_t;
+
+void command_graph::record(const detail::command_group& group) {
+  for (auto& command : group.commands) {
+    // Buffers only need to be created once
+    if (command.type != type_t::unspecified) {
+      commands.push_back(command);
+    }
+  }
+  read_buffers.insert(group.read_buffers.begin(), group.read_buffers.end());
+  write_buffers.insert(group.write_buffers.begin(), group.write_buffers.end());
+  ++num_groups;
+}
+
+void command_graph::plan() {
+  detail::command_group group(static_cast<queue*>(nullptr));
+  group.commands = std::move(commands);
+  group.optimize_window();
+  commands = std::move(group.commands);
+}
+
+void command_graph::issue() {
+  for (auto buf : bound) {
+    buf->init();
+  }
+  bound.clear();
+  detail::command::group_detail::add_recorded(commands, read_buffers,
+                                              write_buffers);
+}
+
+void command_graph::rebind(detail::buffer_base* from,
+                           detail::buffer_base* to) {
+  if (from == to) {
+    return;
+  }
+
+  auto replace = [=](buffer_set& buffers) {
+    if (buffers.erase(from) > 0) {
+      buffers.insert(to);
+    }
+  };
+  replace(read_buffers);
+  replace(write_buffers);
+
+  for (auto& command : commands) {
+    if (command.type == type_t::get_accessor) {
+      auto& acc = command.data.buf_acc;
+      if (acc.data == from) {
+        acc.data = to;
+      }
+    } else if (command.type == type_t::copy_data) {
+      auto& copy = command.data.buf_copy;
+      if (copy.buf.data == from) {
+        copy.buf.data = to;
+        command.function = std::bind(detail::buffer_base::enqueue_command,
+                                     std::placeholders::_1,
+                                     std::placeholders::_2, to, copy.enqueue);
+      }
+    } else if (command.type == type_t::kernel) {
+      auto& src = command.kern->src;
+      auto buffers = src.get_buffers();
+      if (std::find(buffers.begin(), buffers.end(), from) == buffers.end()) {
+        continue;
+      }
+      // Each buffer is a single kernel parameter
+      if (std::find(buffers.begin(), buffers.end(), to) != buffers.end()) {
+        detail::error::report(CL_INVALID_KERNEL_ARGS);
+      }
+      std::replace(buffers.begin(), buffers.end(), from, to);
+      src.rebind(buffers);
+    } else if (command.type == type_t::device_op) {
+      auto op = *command.op;
+      if (op.src.data != from && op.dst.data != from) {
+        continue;
+      }
+      for (auto acc : {&op.src, &op.dst}) {
+        if (acc->data == from) {
+          acc->data = to;
+        }
+      }
+      command.op = std::make_shared<detail::command::device_op>(op);
+      command.function = std::bind(
+          detail::command::group_detail::enqueue_device_op,
+          std::placeholders::_1, std::placeholders::_2, command.op,
+          command.kernel_event);
+    }
+  }
+
+  bound.insert(to);
+}
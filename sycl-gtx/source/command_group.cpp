@@ -2,6 +2,8 @@
 
 #include "SYCL/accessor.h"
 #include "SYCL/buffer.h"
+#include "SYCL/kernel.h"
+#include "SYCL/detail/thread_pool.h"
 #include "SYCL/queue.h"
 #include <map>
 #include <unordered_set>
@@ -16,10 +18,66 @@ void command_group::exit() {
   detail::command::group_detail::last = nullptr;
 }
 
+bool command_group::fuse(command_group& next) {
+  // The fused kernel would run after the host tasks of both groups
+  if (has_host_task()) {
+    return false;
+  }
+  // Other commands of next than its accessors and buffer creation
+  // would run before the fused kernel, so before the kernel of this group
+  for (auto& command : next.commands) {
+    if (command.type != command::type_t::get_accessor &&
+        command.type != command::type_t::unspecified) {
+      return false;
+    }
+  }
+  if (deferred == nullptr || next.deferred == nullptr ||
+      deferred->shape != next.deferred->shape ||
+      deferred->compile_options != next.deferred->compile_options) {
+    return false;
+  }
+  auto& src = deferred->kern->src;
+  auto& next_src = next.deferred->kern->src;
+  if (!src.can_fuse(next_src)) {
+    return false;
+  }
+
+  src.fuse(next_src);
+  next.deferred.reset();
+  append(next);
+  return true;
+}
+
+void command_group::append(command_group& other) {
+  for (auto& command : other.commands) {
+    commands.push_back(std::move(command));
+  }
+  other.commands.clear();
+  read_buffers.insert(other.read_buffers.begin(), other.read_buffers.end());
+  write_buffers.insert(other.write_buffers.begin(), other.write_buffers.end());
+}
+
+void command_group::issue_deferred() {
+  if (deferred == nullptr) {
+    return;
+  }
+  // Can also be called while another group is in scope
+  auto previous = command::group_detail::last;
+  enter();
+  auto kern = std::move(deferred);
+  kern->issue();
+  command::group_detail::last = previous;
+}
+
 // TODO(progtx): Reschedules commands to achieve better performance
 void command_group::optimize() {
   DSELF();
 
+  if (is_optimized) {
+    return;
+  }
+  is_optimized = true;
+
   auto size_to_keep = commands.size();
   std::map<command_t*, bool> keep;
   // keep.reserve(size_to_keep);
@@ -73,6 +131,11 @@ void command_group::optimize() {
           --size_to_keep;
         }
       }
+    } else if (command.type == type_t::host_task) {
+      // The task uses the host data read before it
+      // and can change the host data written after it
+      last_read.clear();
+      was_written.clear();
     }
   }
 
@@ -87,37 +150,277 @@ void command_group::optimize() {
   commands = std::move(saveResults);
 }
 
+// Buffers used by a kernel, false if they are not known
+bool command_group::get_kernel_buffers(const kernel& kern,
+                                       buffer_modes& buffers) {
+  // Kernels created from OpenCL objects have no resources
+  buffers = kern.src.get_buffer_modes();
+  return !buffers.empty();
+}
+
+bool command_group::get_device_buffers(const command_t& command,
+                                       buffer_modes& buffers) {
+  if (command.type == command::type_t::kernel) {
+    return get_kernel_buffers(*command.kern, buffers);
+  }
+  buffers.clear();
+  for (auto acc : {command.op->src, command.op->dst}) {
+    if (acc.data != nullptr) {
+      buffers[acc.data] = acc.mode;
+    }
+  }
+  return true;
+}
+
+void command_group::optimize_window() {
+  DSELF();
+
+  using detail::command::type_t;
+
+  // Device data is current once it has been written, used or read back.
+  // Reading back a buffer doesn't change the device data,
+  // and the host data cannot change until the window is flushed,
+  // so later writes of the same buffer to the device can be dropped.
+  std::set<detail::buffer_base*> on_device;
+  // Only the last read of a buffer needs to be kept
+  std::map<detail::buffer_base*, ::size_t> last_read;
+  vector_class<bool> keep(commands.size(), true);
+
+  for (::size_t i = 0; i < commands.size(); ++i) {
+    auto& command = commands[i];
+    if (command.type == type_t::copy_data) {
+      auto ptr = command.data.buf_copy.buf.data;
+      if (command.data.buf_copy.mode == access::mode::write) {
+        keep[i] = on_device.insert(ptr).second;
+      } else if (command.data.buf_copy.mode == access::mode::read) {
+        auto it = last_read.find(ptr);
+        if (it != last_read.end()) {
+          keep[it->second] = false;
+        }
+        last_read[ptr] = i;
+        on_device.insert(ptr);
+      }
+    } else if (command.type == type_t::kernel ||
+               command.type == type_t::device_op) {
+      buffer_modes buffers;
+      if (!get_device_buffers(command, buffers)) {
+        // Nothing can be assumed about the buffers past this kernel
+        on_device.clear();
+        last_read.clear();
+        continue;
+      }
+      for (auto& buf : buffers) {
+        on_device.insert(buf.first);
+      }
+    } else if (command.type == type_t::host_task) {
+      // Host data can change, and the task uses the reads before it
+      on_device.clear();
+      last_read.clear();
+    }
+  }
+
+  // Reads are delayed until a command writes their buffer on the device,
+  // so kernels are launched as soon as possible
+  decltype(commands) saveResults;
+  vector_class<command_t*> delayed_reads;
+  auto issue_reads = [&]() {
+    for (auto read : delayed_reads) {
+      saveResults.push_back(std::move(*read));
+    }
+    delayed_reads.clear();
+  };
+  auto is_delayed = [&](detail::buffer_base* ptr) {
+    for (auto read : delayed_reads) {
+      if (read->data.buf_copy.buf.data == ptr) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  for (::size_t i = 0; i < commands.size(); ++i) {
+    if (!keep[i]) {
+      continue;
+    }
+    auto& command = commands[i];
+
+    if (command.type == type_t::copy_data) {
+      auto ptr = command.data.buf_copy.buf.data;
+      if (command.data.buf_copy.mode == access::mode::read) {
+        delayed_reads.push_back(&command);
+        continue;
+      }
+      if (is_delayed(ptr)) {
+        issue_reads();
+      }
+    } else if (command.type == type_t::kernel ||
+               command.type == type_t::device_op) {
+      buffer_modes buffers;
+      bool conflict = !get_device_buffers(command, buffers);
+      for (auto& buf : buffers) {
+        if (buf.second != access::mode::read && is_delayed(buf.first)) {
+          conflict = true;
+        }
+      }
+      if (conflict) {
+        issue_reads();
+      }
+    } else if (command.type == type_t::host_task) {
+      issue_reads();
+    }
+    saveResults.push_back(std::move(command));
+  }
+  issue_reads();
+
+  debug() << "commands:" << commands.size() << "->" << saveResults.size();
+  commands = std::move(saveResults);
+}
+
+static void print(const command::info& command) {
+  using detail::command::type_t;
+
+  if (command.type == type_t::get_accessor) {
+    auto& acc = command.data.buf_acc;
+    auto d = debug();
+    d << command.type << acc.data << acc.mode << acc.target;
+  } else if (command.type == type_t::copy_data) {
+    auto& copy = command.data.buf_copy;
+    auto d = debug();
+    d << command.type << copy.buf.data << copy.buf.mode << copy.buf.target
+      << copy.mode;
+  } else {
+    debug() << "command:" << command.name;
+  }
+}
+
 /** Executes all commands in queue and removes them */
 void command_group::flush(vector_class<cl_event> wait_events) {
   DSELF() << q << q->get();
 
-  using detail::command::type_t;
-
-  for (auto& command : commands) {
-    if (command.type == type_t::get_accessor) {
-      auto& acc = command.data.buf_acc;
-      auto d = debug();
-      d << command.type << acc.data << acc.mode << acc.target;
-    } else if (command.type == type_t::copy_data) {
-      auto& copy = command.data.buf_copy;
-      auto d = debug();
-      d << command.type << copy.buf.data << copy.buf.mode << copy.buf.target
-        << copy.mode;
-    } else {
-      debug() << "command:" << command.name;
+  if (q->transfer_q.get() != nullptr) {
+    flush_overlapped(wait_events);
+  } else {
+    for (auto& command : commands) {
+      print(command);
+      command.function(q, wait_events);
     }
-    command.function(q, wait_events);
   }
   commands.clear();
+  is_optimized = false;
 
   auto error = clFlush(q->get());
   detail::error::report(error);
+  if (q->transfer_q.get() != nullptr) {
+    error = clFlush(q->transfer_q.get());
+    detail::error::report(error);
+  }
+}
+
+void command_group::flush_overlapped(
+    const vector_class<cl_event>& wait_events) {
+  using detail::command::type_t;
+
+  // Last command in each queue that used the buffer
+  std::map<buffer_base*, cl_event> last_copy;
+  std::map<buffer_base*, cl_event> last_kernel;
+  // Transfers are in order, so the last copy follows all earlier ones
+  cl_event any_copy = nullptr;
+  // Kernel with unknown buffers
+  cl_event opaque_kernel = nullptr;
+
+  auto add = [](vector_class<cl_event>& events, cl_event ev) {
+    if (ev != nullptr) {
+      events.push_back(ev);
+    }
+  };
+  auto find = [](std::map<buffer_base*, cl_event>& last, buffer_base* buf) {
+    auto it = last.find(buf);
+    return it == last.end() ? nullptr : it->second;
+  };
+
+  for (auto& command : commands) {
+    print(command);
+    auto events = wait_events;
+
+    if (command.type == type_t::copy_data) {
+      auto buf = command.data.buf_copy.buf.data;
+      add(events, find(last_kernel, buf));
+      add(events, opaque_kernel);
+
+      q->is_transferring = true;
+      command.function(q, events);
+      q->is_transferring = false;
+
+      any_copy = buf->events.back().get();
+      last_copy[buf] = any_copy;
+    } else if (command.type == type_t::kernel ||
+               command.type == type_t::device_op) {
+      buffer_modes buffers;
+      bool is_known = get_device_buffers(command, buffers);
+      if (is_known) {
+        for (auto& buf : buffers) {
+          add(events, find(last_copy, buf.first));
+        }
+      } else {
+        add(events, any_copy);
+      }
+
+      command.function(q, events);
+
+      auto ev = command.kernel_event->get();
+      if (!is_known) {
+        opaque_kernel = ev;
+      }
+      for (auto& buf : buffers) {
+        last_kernel[buf.first] = ev;
+        // Later groups copying the buffer wait for the kernel
+        buf.first->events.emplace_back(ev);
+      }
+    } else {
+      command.function(q, events);
+    }
+  }
 }
 
 using namespace detail;
 
 SYCL_THREAD_LOCAL command_group* command::group_detail::last = nullptr;
 
+bool command::group_detail::defer_kernel(deferred_kernel kern) {
+  if (last->deferred != nullptr) {
+    last->issue_deferred();
+    return false;
+  }
+  last->deferred = std::make_shared<deferred_kernel>(std::move(kern));
+  return true;
+}
+
+void command::group_detail::issue_deferred() {
+  last->issue_deferred();
+}
+
+void command::group_detail::add_recorded(
+    const vector_class<info>& commands,
+    const std::set<buffer_base*>& read_buffers,
+    const std::set<buffer_base*>& write_buffers) {
+  last->issue_deferred();
+  last->commands.insert(last->commands.end(), commands.begin(),
+                        commands.end());
+  last->read_buffers.insert(read_buffers.begin(), read_buffers.end());
+  last->write_buffers.insert(write_buffers.begin(), write_buffers.end());
+  last->is_optimized = true;
+}
+
+vector_class<buffer_access> command::group_detail::get_accessors() {
+  vector_class<buffer_access> accessors;
+  for (auto& command : last->commands) {
+    if (command.type == type_t::get_accessor) {
+      accessors.push_back(command.data.buf_acc);
+    }
+  }
+  return accessors;
+}
+
 bool command::group_detail::in_scope() {
   return last != nullptr;
 }
@@ -136,7 +439,9 @@ void command::group_detail::add_buffer_access(buffer_access buf_acc,
                             type_t::get_accessor, metadata(buf_acc)});
 
   // TODO(progtx): Maybe other targets
-  if (buf_acc.target == access::target::global_buffer) {
+  if (buf_acc.target == access::target::global_buffer ||
+      buf_acc.target == access::target::image ||
+      buf_acc.target == access::target::svm) {
     if (buf_acc.mode != access::mode::discard_write &&
         buf_acc.mode != access::mode::discard_read_write) {
       last->read_buffers.insert(buf_acc.data);
@@ -156,5 +461,285 @@ void command::group_detail::add_buffer_copy(
       {name,
        std::bind(function, std::placeholders::_1, std::placeholders::_2, buffer,
                  enqueue_function),
-       type_t::copy_data, metadata(buffer_copy{buf_acc, copy_mode})});
+       type_t::copy_data,
+       metadata(buffer_copy{buf_acc, copy_mode, enqueue_function})});
+}
+
+void command::group_detail::add_device_op(shared_ptr_class<device_op> op,
+                                          string_class name) {
+  // Kernels of the group traced before the operation have to run before it
+  last->issue_deferred();
+
+  auto write_to_device = [&name](const buffer_access& acc) {
+    if (acc.data == nullptr || acc.mode == access::mode::write ||
+        acc.mode == access::mode::discard_write ||
+        acc.mode == access::mode::discard_read_write) {
+      return;
+    }
+    add_buffer_copy(acc, access::mode::write, buffer_base::enqueue_command,
+                    name, acc.data, &clEnqueueWriteBuffer);
+  };
+  write_to_device(op->src);
+  write_to_device(op->dst);
+
+  auto evnt = std::make_shared<event>();
+  last->commands.push_back({name,
+                            std::bind(enqueue_device_op, std::placeholders::_1,
+                                      std::placeholders::_2, op, evnt),
+                            type_t::device_op});
+  last->commands.back().kernel_event = evnt;
+  last->commands.back().op = op;
+
+  if (op->dst.data != nullptr) {
+    add_update_host(op->dst);
+  }
+}
+
+void command::group_detail::enqueue_device_op(
+    queue* q, const vector_class<cl_event>& wait_events,
+    shared_ptr_class<device_op> op, shared_ptr_class<event> evnt) {
+  auto get_mem = [](const buffer_access& acc) -> cl_mem {
+    return acc.data == nullptr ? nullptr : acc.data->device_data.get();
+  };
+  cl_event ev;
+  auto error_code = op->enqueue(q->get(), get_mem(op->src), get_mem(op->dst),
+                                wait_events, &ev);
+  detail::error::report(error_code);
+  *evnt = event(ev);
+  clReleaseEvent(ev);
+}
+
+static const cl_event* get_events_ptr(const vector_class<cl_event>& events) {
+  return events.empty() ? nullptr : events.data();
+}
+
+static ::cl_uint get_num_events(const vector_class<cl_event>& events) {
+  return static_cast<::cl_uint>(events.size());
+}
+
+void command::group_detail::add_fill(buffer_access dst, region dst_region,
+                                     vector_class<char> pattern) {
+  auto op = std::make_shared<device_op>();
+  op->src = {nullptr, access::mode::read, dst.target};
+  op->dst = dst;
+  op->enqueue = [=](cl_command_queue q, cl_mem, cl_mem mem,
+                    const vector_class<cl_event>& wait_events,
+                    cl_event* evnt) {
+    auto& r = dst_region;
+    if (r.is_contiguous()) {
+      return clEnqueueFillBuffer(q, mem, pattern.data(), pattern.size(),
+                                 r.start(), r.bytes(),
+                                 get_num_events(wait_events),
+                                 get_events_ptr(wait_events), evnt);
+    }
+    // There is no rectangular fill, each row is filled on its own.
+    // The queue is in order, so the event of the last row is enough.
+    ::cl_int error_code = CL_SUCCESS;
+    auto row = r;
+    row.size[1] = row.size[2] = 1;
+    for (::size_t z = 0; z < r.size[2]; ++z) {
+      for (::size_t y = 0; y < r.size[1]; ++y) {
+        row.origin[1] = r.origin[1] + y;
+        row.origin[2] = r.origin[2] + z;
+        bool is_last = (z + 1 == r.size[2] && y + 1 == r.size[1]);
+        error_code = clEnqueueFillBuffer(
+            q, mem, pattern.data(), pattern.size(), row.start(), row.bytes(),
+            get_num_events(wait_events), get_events_ptr(wait_events),
+            is_last ? evnt : nullptr);
+        if (error_code != CL_SUCCESS) {
+          return error_code;
+        }
+      }
+    }
+    return error_code;
+  };
+  add_device_op(op, __func__);
+}
+
+void command::group_detail::add_copy(buffer_access src, region src_region,
+                                     buffer_access dst, region dst_region) {
+  if (src_region.size != dst_region.size) {
+    detail::error::report(CL_INVALID_VALUE);
+  }
+  auto op = std::make_shared<device_op>();
+  op->src = src;
+  op->dst = dst;
+  op->enqueue = [=](cl_command_queue q, cl_mem src_mem, cl_mem dst_mem,
+                    const vector_class<cl_event>& wait_events,
+                    cl_event* evnt) {
+    auto& s = src_region;
+    auto& d = dst_region;
+    if (s.is_contiguous() && d.is_contiguous()) {
+      return clEnqueueCopyBuffer(q, src_mem, dst_mem, s.start(), d.start(),
+                                 s.bytes(), get_num_events(wait_events),
+                                 get_events_ptr(wait_events), evnt);
+    }
+    return clEnqueueCopyBufferRect(
+        q, src_mem, dst_mem, s.origin.data(), d.origin.data(), s.size.data(),
+        s.row_pitch, s.slice_pitch, d.row_pitch, d.slice_pitch,
+        get_num_events(wait_events), get_events_ptr(wait_events), evnt);
+  };
+  add_device_op(op, __func__);
+}
+
+void command::group_detail::add_copy_to_host(buffer_access src,
+                                             region src_region, void* dst,
+                                             region dst_region) {
+  auto op = std::make_shared<device_op>();
+  op->src = src;
+  op->dst = {nullptr, access::mode::discard_write, src.target};
+  op->enqueue = [=](cl_command_queue q, cl_mem mem, cl_mem,
+                    const vector_class<cl_event>& wait_events,
+                    cl_event* evnt) {
+    auto& s = src_region;
+    auto& d = dst_region;
+    if (s.is_contiguous()) {
+      return clEnqueueReadBuffer(q, mem, false, s.start(), s.bytes(), dst,
+                                 get_num_events(wait_events),
+                                 get_events_ptr(wait_events), evnt);
+    }
+    return clEnqueueReadBufferRect(
+        q, mem, false, s.origin.data(), d.origin.data(), s.size.data(),
+        s.row_pitch, s.slice_pitch, d.row_pitch, d.slice_pitch, dst,
+        get_num_events(wait_events), get_events_ptr(wait_events), evnt);
+  };
+  add_device_op(op, __func__);
+}
+
+void command::group_detail::add_copy_from_host(const void* src,
+                                               region src_region,
+                                               buffer_access dst,
+                                               region dst_region) {
+  auto op = std::make_shared<device_op>();
+  op->src = {nullptr, access::mode::read, dst.target};
+  op->dst = dst;
+  op->enqueue = [=](cl_command_queue q, cl_mem, cl_mem mem,
+                    const vector_class<cl_event>& wait_events,
+                    cl_event* evnt) {
+    auto& s = src_region;
+    auto& d = dst_region;
+    if (d.is_contiguous()) {
+      return clEnqueueWriteBuffer(q, mem, false, d.start(), d.bytes(), src,
+                                  get_num_events(wait_events),
+                                  get_events_ptr(wait_events), evnt);
+    }
+    return clEnqueueWriteBufferRect(
+        q, mem, false, d.origin.data(), s.origin.data(), d.size.data(),
+        d.row_pitch, d.slice_pitch, s.row_pitch, s.slice_pitch, src,
+        get_num_events(wait_events), get_events_ptr(wait_events), evnt);
+  };
+  add_device_op(op, __func__);
+}
+
+void command::group_detail::add_update_host(buffer_access buf_acc) {
+  last->issue_deferred();
+  add_buffer_copy(buf_acc, access::mode::read, buffer_base::enqueue_command,
+                  __func__, buf_acc.data,
+                  reinterpret_cast<buffer_base::clEnqueueBuffer_f>(  // NOLINT
+                      &clEnqueueReadBuffer));
+}
+
+bool command_group::has_host_task() const {
+  for (auto& command : commands) {
+    if (command.type == command::type_t::host_task) {
+      return true;
+    }
+  }
+  return false;
+}
+
+namespace {
+struct pending_task {
+  function_class<void()> task;
+  cl_event done;
+  shared_ptr_class<async_error_list> errors;
+};
+}  // namespace
+
+static void CL_CALLBACK run_host_task(cl_event ready, ::cl_int status,
+                                      void* data) {
+  shared_ptr_class<pending_task> pending(static_cast<pending_task*>(data));
+  clReleaseEvent(ready);
+
+  if (status < 0) {
+    // The commands the task depends on failed
+    clSetUserEventStatus(pending->done, status);
+    clReleaseEvent(pending->done);
+    return;
+  }
+
+  thread_pool::get().push([pending]() {
+    ::cl_int result = CL_COMPLETE;
+    try {
+      pending->task();
+    } catch (...) {
+      std::lock_guard<mutex_class> guard(pending->errors->lock);
+      error::thrower::add_async(pending->errors->list, "Host task failed");
+      result = CL_INVALID_OPERATION;
+    }
+    clSetUserEventStatus(pending->done, result);
+    clReleaseEvent(pending->done);
+  });
+}
+
+void command_group::enqueue_host_task(queue* q,
+                                      const vector_class<cl_event>& wait_events,
+                                      function_class<void()> task,
+                                      vector_class<buffer_base*> buffers) {
+  ::cl_int error_code;
+  auto transfer_q = q->transfer_q.get();
+
+  // Commands in the transfer queue are not ordered with the command queue
+  auto dependencies = wait_events;
+  cl_event copies = nullptr;
+  if (transfer_q != nullptr) {
+    error_code = clEnqueueMarkerWithWaitList(transfer_q, 0, nullptr, &copies);
+    detail::error::report(error_code);
+    dependencies.push_back(copies);
+  }
+
+  cl_event ready;
+  error_code = clEnqueueMarkerWithWaitList(
+      q->get(), static_cast<::cl_uint>(dependencies.size()),
+      dependencies.empty() ? nullptr : dependencies.data(), &ready);
+  detail::error::report(error_code);
+  if (copies != nullptr) {
+    clReleaseEvent(copies);
+  }
+
+  auto done = clCreateUserEvent(q->get_context().get(), &error_code);
+  detail::error::report(error_code);
+  for (auto command_q : {q->get(), transfer_q}) {
+    if (command_q != nullptr) {
+      error_code = clEnqueueBarrierWithWaitList(command_q, 1, &done, nullptr);
+      detail::error::report(error_code);
+    }
+  }
+  for (auto buf : buffers) {
+    buf->events.emplace_back(done);
+  }
+
+  // Both events are released by the callback
+  error_code = clSetEventCallback(
+      ready, CL_COMPLETE, run_host_task,
+      new pending_task{std::move(task), done, q->ex_list});
+  detail::error::report(error_code);
+}
+
+void command::group_detail::add_host_task(function_class<void()> task) {
+  // Kernels of the group traced before the task have to run before it
+  last->issue_deferred();
+
+  vector_class<buffer_base*> buffers;
+  for (auto& acc : get_accessors()) {
+    // Local accessors have no buffer
+    if (acc.data != nullptr) {
+      buffers.push_back(acc.data);
+    }
+  }
+  last->commands.push_back(
+      {__func__,
+       std::bind(command_group::enqueue_host_task, std::placeholders::_1,
+                 std::placeholders::_2, std::move(task), std::move(buffers)),
+       type_t::host_task});
 }
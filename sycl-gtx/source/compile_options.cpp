@@ -0,0 +1,42 @@
+#include "SYCL/compile_options.h"
+
+using namespace cl::sycl;
+using namespace detail;
+
+string_class compile_options::join(const string_class& first,
+                                   const string_class& second) {
+  if (first.empty()) {
+    return second;
+  }
+  if (second.empty()) {
+    return first;
+  }
+  return first + ' ' + second;
+}
+
+string_class compile_options::fast_math() {
+  return join(fast_relaxed_math, mad_enable, denorms_are_zero);
+}
+
+std::map<::size_t, string_class> compile_options_registry::options;
+mutex_class compile_options_registry::m;
+
+void compile_options_registry::set(::size_t kernel_name_id,
+                                   string_class compile_options) {
+  std::lock_guard<mutex_class> lock(m);
+  options[kernel_name_id] = std::move(compile_options);
+}
+
+void compile_options_registry::remove(::size_t kernel_name_id) {
+  std::lock_guard<mutex_class> lock(m);
+  options.erase(kernel_name_id);
+}
+
+string_class compile_options_registry::get(::size_t kernel_name_id) {
+  std::lock_guard<mutex_class> lock(m);
+  auto it = options.find(kernel_name_id);
+  if (it == options.end()) {
+    return "";
+  }
+  return it->second;
+}
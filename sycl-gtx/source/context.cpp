@@ -1,4 +1,5 @@
 #include "SYCL/context.h"
+#include "SYCL/buffer_pool.h"
 #include "SYCL/device.h"
 #include "SYCL/platform.h"
 
@@ -15,7 +16,7 @@ context::context(cl_context c, const async_handler& asyncHandler,
 
     if (num_devices == 0) {
       target_devices =
-          device_selector::get_platform().get_devices(deviceSelector.type);
+          deviceSelector.get_platform().get_devices(deviceSelector.type);
       num_devices = static_cast<::cl_uint>(target_devices.size());
     }
 
@@ -32,6 +33,7 @@ context::context(cl_context c, const async_handler& asyncHandler,
     ctx = c;
     ctx.release_one();
   }
+  pool = detail::memory_pool::attach(c);
 }
 
 context::context() : context(nullptr, detail::default_async_handler, false) {}
@@ -0,0 +1,42 @@
+#include "SYCL/detail/info_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace cl::sycl;
+using namespace detail;
+
+std::map<info_cache::key_t, vector_class<char>> info_cache::values;
+std::set<const void*> info_cache::roots;
+mutex_class info_cache::m;
+
+bool info_cache::get(const void* object, cl_uint param, ::size_t size,
+                     void* value, ::size_t* actual_size) {
+  std::lock_guard<mutex_class> lock(m);
+  auto it = values.find(key_t(object, param));
+  if (it == values.end() || it->second.size() > size) {
+    return false;
+  }
+  std::memcpy(value, it->second.data(), it->second.size());
+  if (actual_size != nullptr) {
+    *actual_size = it->second.size();
+  }
+  return true;
+}
+
+void info_cache::set(const void* object, cl_uint param, const void* value,
+                     ::size_t size) {
+  auto begin = static_cast<const char*>(value);
+  std::lock_guard<mutex_class> lock(m);
+  values[key_t(object, param)].assign(begin, begin + size);
+}
+
+void info_cache::add_root(const void* device) {
+  std::lock_guard<mutex_class> lock(m);
+  roots.insert(device);
+}
+
+bool info_cache::is_root(const void* device) {
+  std::lock_guard<mutex_class> lock(m);
+  return roots.count(device) > 0;
+}
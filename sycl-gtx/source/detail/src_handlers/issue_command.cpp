@@ -3,6 +3,7 @@
 #include "SYCL/accessors/buffer.h"
 #include "SYCL/buffer.h"
 #include "SYCL/kernel.h"
+#include "SYCL/svm.h"
 
 using namespace cl::sycl;
 using detail::issue_command;
@@ -19,16 +20,61 @@ void issue_command::prepare_kernel(shared_ptr_class<kernel> kern) {
   auto k = kern->get();
   ::cl_int error_code;
   int i = 0;
-  for (auto& acc : kern->src.resources) {
-    if (acc.second.acc.target == access::target::local) {
-      error_code = clSetKernelArg(k, i, acc.second.size, nullptr);
+  for (auto key : kern->src.arguments) {
+    auto& acc = kern->src.resources.at(key);
+    if (acc.acc.target == access::target::local) {
+      error_code = clSetKernelArg(k, i, acc.size, nullptr);
+#ifdef CL_VERSION_2_0
+    } else if (acc.acc.target == access::target::svm) {
+      auto svm = static_cast<svm_base*>(acc.acc.data);
+      error_code = clSetKernelArgSVMPointer(k, i, svm->pointer);
+#endif
     } else {
-      auto mem = acc.second.acc.data->device_data.get();
-      error_code = clSetKernelArg(k, i, acc.second.size, &mem);
+      auto mem = acc.acc.data->device_data.get();
+      error_code = clSetKernelArg(k, i, acc.size, &mem);
     }
     detail::error::report(error_code);
     ++i;
   }
+
+#ifdef CL_VERSION_2_0
+  auto& allocations = kern->src.svm_allocations;
+  if (!allocations.empty()) {
+    vector_class<void*> pointers;
+    pointers.reserve(allocations.size());
+    for (auto buf : allocations) {
+      pointers.push_back(static_cast<svm_base*>(buf)->pointer);
+    }
+    error_code = clSetKernelExecInfo(k, CL_KERNEL_EXEC_INFO_SVM_PTRS,
+                                     pointers.size() * sizeof(void*),
+                                     pointers.data());
+    detail::error::report(error_code);
+  }
+#endif
+}
+
+void issue_command::add_svm_events(shared_ptr_class<kernel> kern,
+                                   shared_ptr_class<event> evnt) {
+  auto ev = evnt->get();
+  for (auto& acc : kern->src.resources) {
+    if (acc.second.acc.target == access::target::svm) {
+      acc.second.acc.data->events.emplace_back(ev);
+    }
+  }
+  for (auto buf : kern->src.svm_allocations) {
+    buf->events.emplace_back(ev);
+  }
+}
+
+void issue_command::declare_svm(shared_ptr_class<kernel> kern) {
+  auto& allocations = kern->src.svm_allocations;
+  allocations.clear();
+  for (auto& acc : command::group_detail::get_accessors()) {
+    if (acc.target == access::target::svm &&
+        kern->src.resources.count(acc.data) == 0) {
+      allocations.push_back(acc.data);
+    }
+  }
 }
 
 void issue_command::write_buffers_to_device(shared_ptr_class<kernel> kern) {
@@ -36,7 +82,8 @@ void issue_command::write_buffers_to_device(shared_ptr_class<kernel> kern) {
     auto mode = acc.second.acc.mode;
     if (mode == access::mode::write || mode == access::mode::discard_write ||
         mode == access::mode::discard_read_write ||
-        acc.second.acc.target == access::target::local) {
+        acc.second.acc.target == access::target::local ||
+        acc.second.acc.target == access::target::svm) {
       // Don't need to copy data that won't be used
       continue;
     }
@@ -48,12 +95,14 @@ void issue_command::write_buffers_to_device(shared_ptr_class<kernel> kern) {
 
 void issue_command::enqueue_task_command(
     queue* q, const vector_class<cl_event>& wait_events,
-    shared_ptr_class<kernel> kern, event* evnt) {
+    shared_ptr_class<kernel> kern, shared_ptr_class<event> evnt) {
   prepare_kernel(kern);
-  kern->enqueue_task(q, wait_events, evnt);
+  kern->enqueue_task(q, wait_events, evnt.get());
+  add_svm_events(kern, evnt);
 }
 
-void issue_command::enqueue_task(shared_ptr_class<kernel> kern, event* evnt) {
+void issue_command::enqueue_task(shared_ptr_class<kernel> kern,
+                                 shared_ptr_class<event> evnt) {
   command::group_detail::add_kernel_enqueue_task(enqueue_task_command, __func__,
                                                  kern, evnt);
 }
@@ -61,7 +110,8 @@ void issue_command::enqueue_task(shared_ptr_class<kernel> kern, event* evnt) {
 void issue_command::read_buffers_from_device(shared_ptr_class<kernel> kern) {
   for (auto& acc : kern->src.resources) {
     if (acc.second.acc.mode == access::mode::read ||
-        acc.second.acc.target == access::target::local) {
+        acc.second.acc.target == access::target::local ||
+        acc.second.acc.target == access::target::svm) {
       // Don't need to read back read-only buffers
       continue;
     }
@@ -5,44 +5,226 @@
 #include "SYCL/error_handler.h"
 #include "SYCL/kernel.h"
 #include "SYCL/program.h"
+#include <cctype>
+#include <cstdint>
 
 using namespace cl::sycl;
 using namespace detail::kernel_ns;
 
 const string_class source::resource_name_root = "_sycl_buf";
-SYCL_THREAD_LOCAL int source::num_resources = 0;
 SYCL_THREAD_LOCAL source* source::scope = nullptr;
 
 bool source::in_scope() {
   return scope != nullptr;
 }
 
+static bool is_identifier(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Length of a generated variable name, such as _uint_17 or __sycl_half4_2,
+// starting at pos, 0 if there is none
+static ::size_t variable_length(const string_class& line, ::size_t pos,
+                                ::size_t& type_length) {
+  if (line[pos] != '_' || (pos > 0 && is_identifier(line[pos - 1]))) {
+    return 0;
+  }
+  auto end = pos + 1;
+  while (end < line.size() && is_identifier(line[end])) {
+    ++end;
+  }
+
+  // The counter follows the last underscore
+  auto separator = line.rfind('_', end - 1);
+  if (separator == pos || separator + 1 == end) {
+    return 0;
+  }
+  for (auto i = separator + 1; i < end; ++i) {
+    if (!std::isdigit(static_cast<unsigned char>(line[i]))) {
+      return 0;
+    }
+  }
+
+  // The type name is lower case, followed by the number of vector elements
+  auto i = pos + 1;
+  while (i < separator && (std::islower(static_cast<unsigned char>(line[i])) ||
+                           line[i] == '_')) {
+    ++i;
+  }
+  if (i == pos + 1) {
+    return 0;
+  }
+  while (i < separator && std::isdigit(static_cast<unsigned char>(line[i]))) {
+    ++i;
+  }
+  if (i != separator) {
+    return 0;
+  }
+  type_length = separator + 1 - pos;
+  return end - pos;
+}
+
+// Variables are named from counters shared by all kernels.
+// They are numbered again per type in order of appearance,
+// so the same kernel always gets the same names.
+static void renumber_variables(vector_class<string_class>& lines) {
+  std::map<string_class, string_class> names;
+  std::map<string_class, ::size_t> next;
+
+  for (auto& line : lines) {
+    string_class renamed;
+    ::size_t from = 0;
+    for (::size_t pos = 0; pos < line.size(); ++pos) {
+      ::size_t type_length;
+      auto length = variable_length(line, pos, type_length);
+      if (length == 0) {
+        continue;
+      }
+
+      auto name = line.substr(pos, length);
+      auto it = names.find(name);
+      if (it == names.end()) {
+        auto type = line.substr(pos, type_length);
+        auto number = detail::get_string<::size_t>::get(next[type]++);
+        it = names.emplace(name, type + number).first;
+      }
+      renamed.append(line, from, pos - from);
+      renamed += it->second;
+      from = pos + length;
+      pos = from - 1;
+    }
+    renamed.append(line, from, string_class::npos);
+    line = std::move(renamed);
+  }
+}
+
+// 64-bit FNV-1a
+static ::size_t hash(const string_class& text) {
+  std::uint64_t h = 14695981039346656037ull;
+  for (auto c : text) {
+    h ^= static_cast<unsigned char>(c);
+    h *= 1099511628211ull;
+  }
+  return static_cast<::size_t>(h);
+}
+
 void source::enter(source& src) {
   scope = &src;
-  num_resources = 0;
 }
 
 source source::exit(source& src) {
   scope = nullptr;
+  renumber_variables(src.lines);
+  src.generate_name();
   return src;
 }
 
 /** Creates kernel source */
 string_class source::get_code() const {
-  // TODO(progtx): Caching?
+  return generate_declarations() + "__kernel void " + kernel_name +
+         generate_body();
+}
+
+// Half types and the functions accessing buffers of half.
+// Devices with cl_khr_fp16 compute in half,
+// the other devices convert the values from and to float.
+static string_class half_declarations() {
+  static const int sizes[] = {1, 2, 3, 4, 8, 16};
+  string_class native =
+      "#ifdef cl_khr_fp16\n#pragma OPENCL EXTENSION cl_khr_fp16 : enable\n";
+  string_class converted = "#else\n";
+
+  for (auto size : sizes) {
+    auto n = (size == 1) ? "" : detail::get_string<int>::get(size);
+    auto load = "#define _sycl_vload_half" + n + "(i, p) ";
+    auto store = "#define _sycl_vstore_half" + n + "(v, i, p) ";
+
+    native += "#define _sycl_half" + n + " half" + n + '\n';
+    if (size == 1) {
+      native += load + "(p)[i]\n" + store + "((p)[i] = (v))\n";
+    } else if (size == 3) {
+      // Same as on the host, 3 elements take the space of 4
+      native += load + "vload4(i, p).xyz\n" + store +
+                "vstore3(v, 0, (p) + 4 * (i))\n";
+    } else {
+      native += load + "vload" + n + "(i, p)\n" + store + "vstore" + n +
+                "(v, i, p)\n";
+    }
+
+    // The aligned variants also use the space of 4 for 3 elements
+    auto aligned = (size == 1) ? "" : "a";
+    converted += "#define _sycl_half" + n + " float" + n + '\n' + load +
+                 "vload" + aligned + "_half" + n + "(i, p)\n" + store +
+                 "vstore" + aligned + "_half" + n + "(v, i, p)\n";
+  }
+
+  return native + converted + "#endif\n";
+}
+
+bool source::uses_half() const {
+  for (auto& res : resources) {
+    if (res.second.type_name == "half*") {
+      return true;
+    }
+  }
+  for (auto& line : lines) {
+    if (line.find("_sycl_half") != string_class::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Program scope declarations used by the kernel
+string_class source::generate_declarations() const {
+  string_class declarations;
+  if (uses_half()) {
+    static const auto half = half_declarations();
+    declarations += half;
+  }
+  for (auto& smpl : samplers) {
+    declarations +=
+        "const sampler_t " + smpl.first + " = " + smpl.second + ";\n";
+  }
+  return declarations;
+}
 
+// Everything after the kernel name
+string_class source::generate_body() const {
   static const char newline = '\n';
 
-  string_class final_code = string_class("__kernel void ") + kernel_name + "(" +
-                            generate_accessor_list() + ") {" + newline;
+  string_class body = "(" + generate_accessor_list() + ") {" + newline;
+
+  for (auto key : arguments) {
+    auto& acc = resources.at(key);
+    if (!acc.rebase.empty()) {
+      body += "\t" + acc.resource_name + " -= " + acc.rebase + ';' + newline;
+    }
+  }
 
   for (auto& line : lines) {
-    final_code += line + newline;
+    body += line + newline;
   }
 
-  final_code = final_code + "}" + newline;
+  body = body + "}" + newline;
+
+  return body;
+}
+
+/**
+ * The name is derived from the rest of the code,
+ * so the same kernel is always compiled from the same source
+ */
+void source::generate_name() {
+  static const char digits[] = "0123456789abcdef";
 
-  return final_code;
+  auto h = hash(generate_declarations() + generate_body());
+  string_class suffix;
+  for (::size_t i = 0; i < 2 * sizeof(h); ++i) {
+    suffix.insert(suffix.begin(), digits[h & 0xF]);
+    h >>= 4;
+  }
+  kernel_name = "_sycl_kernel_" + suffix;
 }
 
 string_class source::get_kernel_name() const {
@@ -55,13 +237,20 @@ string_class source::generate_accessor_list() const {
     return list;
   }
 
-  for (auto& acc : resources) {
-    list += get_name(acc.second.acc.target) + " ";
-    if (acc.second.acc.mode == access::mode::read) {
-      list += "const ";
+  for (auto key : arguments) {
+    auto& acc = resources.at(key);
+    if (acc.acc.target == access::target::image) {
+      // Kernels can either read or write an image
+      list += (acc.acc.mode == access::mode::read ? "__read_only "
+                                                  : "__write_only ");
+    } else {
+      list += get_name(acc.acc.target) + " ";
+      if (acc.acc.mode == access::mode::read) {
+        list += "const ";
+      }
     }
-    list += acc.second.type_name + " ";
-    list += acc.second.resource_name + ", ";
+    list += acc.type_name + " ";
+    list += acc.resource_name + ", ";
   }
 
   // 2 to get rid of the last comma and space
@@ -77,11 +266,96 @@ string_class source::get_name(access::target target) {
       return "__constant";
     case access::target::local:
       return "__local";
+    case access::target::svm:
+      return "__global";
     default:
       return "";
   }
 }
 
+string_class source::register_sampler(const sampler& smpl) {
+  string_class flags;
+  switch (smpl.normalization) {
+    case coordinate_normalization_mode::normalized:
+      flags = "CLK_NORMALIZED_COORDS_TRUE";
+      break;
+    default:
+      flags = "CLK_NORMALIZED_COORDS_FALSE";
+      break;
+  }
+  switch (smpl.addressing) {
+    case addressing_mode::mirrored_repeat:
+      flags += " | CLK_ADDRESS_MIRRORED_REPEAT";
+      break;
+    case addressing_mode::repeat:
+      flags += " | CLK_ADDRESS_REPEAT";
+      break;
+    case addressing_mode::clamp_to_edge:
+      flags += " | CLK_ADDRESS_CLAMP_TO_EDGE";
+      break;
+    case addressing_mode::clamp:
+      flags += " | CLK_ADDRESS_CLAMP";
+      break;
+    default:
+      flags += " | CLK_ADDRESS_NONE";
+      break;
+  }
+  switch (smpl.filtering) {
+    case filtering_mode::linear:
+      flags += " | CLK_FILTER_LINEAR";
+      break;
+    default:
+      flags += " | CLK_FILTER_NEAREST";
+      break;
+  }
+
+  // Same samplers share a constant
+  auto name = "_sycl_sampler" +
+              get_string<int>::get(static_cast<int>(smpl.normalization)) +
+              get_string<int>::get(static_cast<int>(smpl.addressing)) +
+              get_string<int>::get(static_cast<int>(smpl.filtering));
+  if (scope != nullptr) {
+    scope->samplers[name] = flags;
+  }
+  return name;
+}
+
+string_class detail::kernel_ns::register_sampler(const sampler& smpl) {
+  return source::register_sampler(smpl);
+}
+
+string_class source::register_svm(buffer_base* svm, access::mode mode,
+                                  const string_class& type_name) {
+  if (scope == nullptr) {
+    return "";
+  }
+
+  auto it = scope->resources.find(svm);
+  if (it != scope->resources.end()) {
+    // Pointers with different modes to the same allocation
+    if (it->second.acc.mode != mode) {
+      it->second.acc.mode = access::mode::read_write;
+    }
+    return it->second.resource_name;
+  }
+
+  auto resource_name = resource_name_root +
+                       get_string<::size_t>::get(scope->arguments.size() + 1);
+  scope->resources[svm] = {{svm, mode, access::target::svm},
+                           resource_name,
+                           type_name + '*',
+                           sizeof(void*),
+                           ""};
+  scope->arguments.push_back(svm);
+  return resource_name;
+}
+
+string_class detail::kernel_ns::register_svm(buffer_base* svm,
+                                             access::mode mode,
+                                             const string_class& type_name) {
+  return source::register_svm(svm, mode, type_name);
+}
+
 void source::init_kernel(program& p, shared_ptr_class<kernel> kern) {
   ::cl_int error_code;
   cl_kernel k = clCreateKernel(p.get(), kernel_name.c_str(), &error_code);
@@ -89,3 +363,172 @@ void source::init_kernel(program& p, shared_ptr_class<kernel> kern) {
   kern->set(k);
   kern->kern.release_one();
 }
+
+std::map<detail::buffer_base*, access::mode> source::get_buffer_modes()
+    const {
+  std::map<detail::buffer_base*, access::mode> buffers;
+  for (auto& res : resources) {
+    auto& acc = res.second.acc;
+    if (acc.target != access::target::local) {
+      buffers[acc.data] = acc.mode;
+    }
+  }
+  return buffers;
+}
+
+vector_class<detail::buffer_base*> source::get_buffers() const {
+  vector_class<detail::buffer_base*> buffers;
+  buffers.reserve(arguments.size());
+  for (auto key : arguments) {
+    buffers.push_back(resources.at(key).acc.data);
+  }
+  return buffers;
+}
+
+void source::rebind(const vector_class<detail::buffer_base*>& buffers) {
+  decltype(resources) rebound;
+  for (::size_t i = 0; i < arguments.size(); ++i) {
+    auto info = resources.at(arguments[i]);
+    info.acc.data = buffers[i];
+    arguments[i] = buffers[i];
+    rebound.emplace(buffers[i], std::move(info));
+  }
+  resources = std::move(rebound);
+}
+
+// Position of the next resource name in the line, npos if there is none
+static ::size_t find_resource(const string_class& line,
+                              const string_class& root, ::size_t pos,
+                              ::size_t& length) {
+  pos = line.find(root, pos);
+  if (pos == string_class::npos) {
+    return pos;
+  }
+  auto end = pos + root.size();
+  while (end < line.size() &&
+         std::isdigit(static_cast<unsigned char>(line[end]))) {
+    ++end;
+  }
+  length = end - pos;
+  return pos;
+}
+
+bool source::is_fusable(const buf_info& info) {
+  return (info.acc.target == access::target::global_buffer ||
+          info.acc.target == access::target::constant_buffer) &&
+         info.acc.mode != access::mode::atomic && info.rebase.empty();
+}
+
+bool source::is_elementwise(const vector_class<string_class>& lines,
+                            const string_class& resource_name) {
+  static const string_class own_id = "[_sycl_gid]";
+  ::size_t length;
+
+  for (auto& line : lines) {
+    auto pos = find_resource(line, resource_name_root, 0, length);
+    for (; pos != string_class::npos;
+         pos = find_resource(line, resource_name_root, pos + length, length)) {
+      if (line.compare(pos, length, resource_name) == 0 &&
+          line.compare(pos + length, own_id.size(), own_id) != 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool source::can_fuse(const source& next) const {
+  for (auto& res : resources) {
+    if (!is_fusable(res.second)) {
+      return false;
+    }
+  }
+
+  for (auto& res : next.resources) {
+    if (!is_fusable(res.second)) {
+      return false;
+    }
+
+    auto it = resources.find(res.first);
+    if (it == resources.end()) {
+      continue;
+    }
+    auto& first = it->second.acc;
+    auto& second = res.second.acc;
+    if (first.target != second.target) {
+      return false;
+    }
+    if (first.mode == access::mode::read &&
+        second.mode == access::mode::read) {
+      continue;
+    }
+
+    // A work item would otherwise see elements of other work items
+    // before or after the other kernel has processed them
+    if (!is_elementwise(lines, it->second.resource_name) ||
+        !is_elementwise(next.lines, res.second.resource_name)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Mode of a buffer accessed by one kernel and then by the next
+static access::mode merge_mode(access::mode first, access::mode second) {
+  if (first == second) {
+    return first;
+  }
+  if (first == access::mode::read || first == access::mode::read_write) {
+    return access::mode::read_write;
+  }
+  // The first kernel replaces the contents
+  return first;
+}
+
+void source::fuse(const source& next) {
+  if (!is_fused) {
+    for (auto& line : lines) {
+      line.insert(0, 1, '\t');
+    }
+    lines.insert(lines.begin(), "\t{");
+    lines.push_back("\t}");
+    is_fused = true;
+  }
+
+  std::map<string_class, string_class> names;
+  for (auto& res : next.resources) {
+    auto it = resources.find(res.first);
+    if (it == resources.end()) {
+      auto info = res.second;
+      info.resource_name = resource_name_root +
+                           get_string<::size_t>::get(resources.size() + 1);
+      it = resources.emplace(res.first, std::move(info)).first;
+      arguments.push_back(res.first);
+    } else {
+      auto& mode = it->second.acc.mode;
+      mode = merge_mode(mode, res.second.acc.mode);
+    }
+    names[res.second.resource_name] = it->second.resource_name;
+  }
+
+  lines.push_back("\t{");
+  for (auto& line : next.lines) {
+    string_class renamed("\t");
+    ::size_t from = 0;
+    ::size_t length;
+    auto pos = find_resource(line, resource_name_root, 0, length);
+    for (; pos != string_class::npos;
+         pos = find_resource(line, resource_name_root, from, length)) {
+      renamed.append(line, from, pos - from);
+      auto name = line.substr(pos, length);
+      auto it = names.find(name);
+      renamed += (it == names.end() ? name : it->second);
+      from = pos + length;
+    }
+    renamed.append(line, from, string_class::npos);
+    lines.push_back(std::move(renamed));
+  }
+  lines.push_back("\t}");
+  generate_name();
+}
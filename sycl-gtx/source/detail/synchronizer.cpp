@@ -9,6 +9,7 @@ using namespace detail;
 
 std::set<queue*> synchronizer::queues;
 std::map<accessor_base*, buffer_base*> synchronizer::host_accessors;
+std::set<buffer_base*> synchronizer::synchronized;
 
 void synchronizer::wait_on_queues(buffer_base* buf) {
   for (auto&& q : queues) {
@@ -36,8 +37,20 @@ void synchronizer::remove(queue* q) {
 
 void synchronizer::add(accessor_base* acc, buffer_base* buf) {
   DSELF() << acc << buf;
+  // Commands using the buffer cannot be flushed while a host accessor exists,
+  // so only the first one has to wait
+  bool is_accessed = false;
+  for (auto&& other : host_accessors) {
+    if (other.second == buf) {
+      is_accessed = true;
+      break;
+    }
+  }
+  if (synchronized.erase(buf) == 0 && !is_accessed) {
+    // Held back commands have to be flushed before the accessor blocks them
+    wait_on_queues(buf);
+  }
   host_accessors.emplace(acc, buf);
-  wait_on_queues(buf);
 }
 
 void synchronizer::remove(accessor_base* acc, buffer_base* buf) {
@@ -45,6 +58,25 @@ void synchronizer::remove(accessor_base* acc, buffer_base* buf) {
   flush_queues(buf);
 }
 
+vector_class<event> synchronizer::request(buffer_base* buf) {
+  flush_queues(buf);
+  return buf->events;
+}
+
+void synchronizer::synchronize(buffer_base* buf) {
+  event::wait(request(buf));
+  synchronized.insert(buf);
+}
+
+void synchronizer::submit_deferred(buffer_base* buf) {
+  for (auto&& q : queues) {
+    if (q->buffers_in_use.count(buf) > 0) {
+      q->flush_deferred();
+      q->flush_window();
+    }
+  }
+}
+
 bool synchronizer::can_flush(
     const std::set<detail::buffer_base*>& buffers_in_use) {
   {
@@ -0,0 +1,53 @@
+#include "SYCL/detail/thread_pool.h"
+
+#include <algorithm>
+
+using namespace cl::sycl;
+using detail::thread_pool;
+
+thread_pool::thread_pool(::size_t num_threads) {
+  workers.reserve(num_threads);
+  for (::size_t i = 0; i < num_threads; ++i) {
+    workers.emplace_back(&thread_pool::work, this);
+  }
+}
+
+thread_pool::~thread_pool() {
+  {
+    std::lock_guard<mutex_class> guard(lock);
+    is_stopping = true;
+  }
+  available.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+void thread_pool::work() {
+  while (true) {
+    function_class<void()> task;
+    {
+      std::unique_lock<mutex_class> guard(lock);
+      available.wait(guard, [this]() { return is_stopping || !tasks.empty(); });
+      if (tasks.empty()) {
+        return;
+      }
+      task = std::move(tasks.front());
+      tasks.pop();
+    }
+    task();
+  }
+}
+
+void thread_pool::push(function_class<void()> task) {
+  {
+    std::lock_guard<mutex_class> guard(lock);
+    tasks.push(std::move(task));
+  }
+  available.notify_one();
+}
+
+thread_pool& thread_pool::get() {
+  static thread_pool pool(std::max(1u, std::thread::hardware_concurrency()));
+  return pool;
+}
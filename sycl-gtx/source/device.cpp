@@ -77,6 +77,12 @@ vector_class<device> detail::get_devices(cl_device_type device_type,
   cl_uint num_devices;
   auto error_code = clGetDeviceIDs(platform_id, device_type, MAX_DEVICES,
                                    device_ids, &num_devices);
+  if (error_code == CL_DEVICE_NOT_FOUND) {
+    return {};
+  }
   detail::error::report(error_code);
+  for (cl_uint i = 0; i < num_devices; ++i) {
+    info_cache::add_root(device_ids[i]);
+  }
   return vector_class<device>(device_ids, device_ids + num_devices);
 }
@@ -2,6 +2,10 @@
 #include "SYCL/detail/debug.h"
 #include "SYCL/device.h"
 #include "SYCL/platform.h"
+#include "SYCL/refc.h"
+#include <cmath>
+#include <cstdio>
+#include <map>
 
 using namespace cl::sycl;
 
@@ -32,26 +36,195 @@ device device_selector::select_device(vector_class<device> devices) const {
   }
 }
 
-platform device_selector::get_platform() {
+platform device_selector::get_platform() const {
   auto platforms = platform::get_platforms();
-  // TODO(progtx): Platform selection
-  return std::move(platforms[0]);
+  ::size_t best_id = 0;
+  int best_score = -1;
+
+  for (::size_t i = 0; i < platforms.size(); ++i) {
+    for (auto& dev : platforms[i].get_devices(type)) {
+      int score = operator()(dev);
+      if (score > best_score) {
+        best_id = i;
+        best_score = score;
+      }
+    }
+  }
+
+  // Without any usable device, device selection reports the failure
+  return std::move(platforms[best_id]);
 }
 
 device device_selector::select_device() const {
   return select_device(get_platform().get_devices(type));
 }
 
+static int log2_score(double value) {
+  return (value < 1) ? 0 : static_cast<int>(std::log2(value));
+}
+
+int detail::device_score(const device& dev) {
+  if (!dev.get_info<info::device::is_available>() ||
+      !dev.get_info<info::device::is_compiler_available>()) {
+    return -1;
+  }
+
+  // Device type has the largest weight,
+  // the rest only orders devices of the same type
+  int score;
+  auto type = static_cast<cl_device_type>(
+      dev.get_info<info::device::device_type>());
+  if (type & CL_DEVICE_TYPE_GPU) {
+    score = 4000;
+  } else if (type & CL_DEVICE_TYPE_ACCELERATOR) {
+    score = 3000;
+  } else if (type & CL_DEVICE_TYPE_CPU) {
+    score = 2000;
+  } else {
+    score = 1000;
+  }
+
+  auto compute_units = dev.get_info<info::device::max_compute_units>();
+  auto clock = dev.get_info<info::device::max_clock_frequency>();
+  auto global_mem = dev.get_info<info::device::global_mem_size>();
+  auto local_mem = dev.get_info<info::device::local_mem_size>();
+
+  // Logarithmic, so that no single property dominates
+  score += 100 * log2_score(static_cast<double>(compute_units) * clock);
+  score += 50 * log2_score(global_mem / 1048576.0);
+  score += 10 * log2_score(local_mem / 1024.0);
+
+  // "OpenCL <major>.<minor> <vendor-specific information>"
+  int major = 1;
+  int minor = 0;
+  std::sscanf(dev.get_info<info::device::device_version>().c_str(),
+              "OpenCL %d.%d", &major, &minor);
+  score += 100 * major + 10 * minor;
+
+  return score;
+}
+
 int default_selector::operator()(const device& dev) const {
-  return 0;
+  return detail::device_score(dev);
 }
 
 int gpu_selector::operator()(const device& dev) const {
-  return 0;
+  return dev.is_gpu() ? detail::device_score(dev) : -1;
 }
 
 int cpu_selector::operator()(const device& dev) const {
-  return 0;
+  return dev.is_cpu() ? detail::device_score(dev) : -1;
+}
+
+namespace {
+
+const char* calibration_source =
+    "__kernel void calibrate(__global float* data, int iterations) {\n"
+    "\tsize_t i = get_global_id(0);\n"
+    "\tfloat x = data[i];\n"
+    "\tfloat y = x + 1.0f;\n"
+    "\tfor(int k = 0; k < iterations; ++k) {\n"
+    "\t\tx = mad(x, 0.999f, y);\n"
+    "\t\ty = mad(y, 0.999f, x);\n"
+    "\t}\n"
+    "\tdata[i] = x + y;\n"
+    "}\n";
+
+// Each iteration has two multiply-adds
+const int calibration_iterations = 1024;
+const ::size_t calibration_items = 1 << 16;
+
+/** @return billions of floating point operations per second, 0 on failure */
+double run_calibration(cl_device_id dev) {
+  using namespace detail;
+  ::cl_int error_code;
+
+  refc<cl_context> ctx(
+      clCreateContext(nullptr, 1, &dev, nullptr, nullptr, &error_code),
+      clReleaseContext);
+  if (error_code != CL_SUCCESS) {
+    return 0;
+  }
+  refc<cl_command_queue> q(
+      clCreateCommandQueue(ctx.get(), dev, CL_QUEUE_PROFILING_ENABLE,
+                           &error_code),
+      clReleaseCommandQueue);
+  if (error_code != CL_SUCCESS) {
+    return 0;
+  }
+  refc<cl_program> prog(clCreateProgramWithSource(ctx.get(), 1,
+                                                  &calibration_source,
+                                                  nullptr, &error_code),
+                        clReleaseProgram);
+  if (error_code != CL_SUCCESS ||
+      clBuildProgram(prog.get(), 1, &dev, "", nullptr, nullptr) !=
+          CL_SUCCESS) {
+    return 0;
+  }
+  refc<cl_kernel> kern(clCreateKernel(prog.get(), "calibrate", &error_code),
+                       clReleaseKernel);
+  if (error_code != CL_SUCCESS) {
+    return 0;
+  }
+  refc<cl_mem> data(clCreateBuffer(ctx.get(), CL_MEM_READ_WRITE,
+                                   calibration_items * sizeof(float), nullptr,
+                                   &error_code),
+                    clReleaseMemObject);
+  if (error_code != CL_SUCCESS) {
+    return 0;
+  }
+
+  auto mem = data.get();
+  ::cl_int iterations = calibration_iterations;
+  cl_event evnt;
+  if (clSetKernelArg(kern.get(), 0, sizeof(cl_mem), &mem) != CL_SUCCESS ||
+      clSetKernelArg(kern.get(), 1, sizeof(iterations), &iterations) !=
+          CL_SUCCESS ||
+      clEnqueueNDRangeKernel(q.get(), kern.get(), 1, nullptr,
+                             &calibration_items, nullptr, 0, nullptr,
+                             &evnt) != CL_SUCCESS) {
+    return 0;
+  }
+  refc<cl_event> done(evnt, clReleaseEvent);
+
+  cl_ulong start = 0;
+  cl_ulong end = 0;
+  if (clWaitForEvents(1, &evnt) != CL_SUCCESS ||
+      clGetEventProfilingInfo(evnt, CL_PROFILING_COMMAND_START, sizeof(start),
+                              &start, nullptr) != CL_SUCCESS ||
+      clGetEventProfilingInfo(evnt, CL_PROFILING_COMMAND_END, sizeof(end),
+                              &end, nullptr) != CL_SUCCESS ||
+      end <= start) {
+    return 0;
+  }
+
+  auto operations = 4.0 * calibration_iterations * calibration_items;
+  return operations / static_cast<double>(end - start);
+}
+
+}  // namespace
+
+int benchmark_selector::operator()(const device& dev) const {
+  static std::map<cl_device_id, int> ranking;
+  static mutex_class m;
+
+  std::lock_guard<mutex_class> lock(m);
+  auto it = ranking.find(dev.get());
+  if (it != ranking.end()) {
+    return it->second;
+  }
+
+  int score = detail::device_score(dev);
+  if (score >= 0) {
+    auto gflops = run_calibration(dev.get());
+    if (gflops > 0) {
+      // Above any heuristic score
+      score = 100000 + static_cast<int>(std::min(gflops * 10, 1e9));
+    }
+  }
+
+  ranking[dev.get()] = score;
+  return score;
 }
 
 int host_selector::operator()(const device& dev) const {
@@ -0,0 +1,137 @@
+#include "SYCL/distributed_queue.h"
+
+#include <algorithm>
+
+using namespace cl::sycl;
+
+SYCL_THREAD_LOCAL detail::partition* detail::partition::current = nullptr;
+
+const double distributed_queue::smoothing = 0.5;
+
+distributed_queue::device_queue::device_queue(const context& syclContext,
+                                              const device& syclDevice,
+                                              const async_handler& asyncHandler)
+    : q(syclContext, syclDevice, true, asyncHandler), is_measured(false) {
+  // Only a starting point, replaced by measurements
+  throughput = static_cast<double>(
+      syclDevice.get_info<info::device::max_compute_units>() *
+      syclDevice.get_info<info::device::max_clock_frequency>());
+  throughput = std::max(throughput, 1.0);
+}
+
+distributed_queue::distributed_queue(const context& syclContext,
+                                     const async_handler& asyncHandler) {
+  for (auto& dev : syclContext.get_devices()) {
+    devices.emplace_back(new device_queue(syclContext, dev, asyncHandler));
+
+    // Sub-buffer origins have to be aligned to the base address alignment
+    ::size_t align_bits = dev.get_info<info::device::mem_base_addr_align>();
+    granularity = std::max(granularity, align_bits / 8);
+  }
+}
+
+vector_class<::size_t> distributed_queue::split(::size_t total) const {
+  auto num_devices = devices.size();
+  vector_class<::size_t> counts(num_devices, 0);
+
+  if (total < 2 * granularity) {
+    // Not worth splitting
+    auto fastest = std::max_element(
+        devices.begin(), devices.end(),
+        [](const unique_ptr_class<device_queue>& a,
+           const unique_ptr_class<device_queue>& b) {
+          return a->throughput < b->throughput;
+        });
+    counts[fastest - devices.begin()] = total;
+    return counts;
+  }
+
+  double sum = 0;
+  for (auto& d : devices) {
+    sum += d->throughput;
+  }
+
+  double accumulated = 0;
+  ::size_t offset = 0;
+  for (::size_t i = 0; i + 1 < num_devices; ++i) {
+    accumulated += devices[i]->throughput;
+    auto end = static_cast<::size_t>(total * (accumulated / sum) + 0.5);
+    end = std::max(end / granularity * granularity, offset);
+    counts[i] = end - offset;
+    offset = end;
+  }
+  counts.back() = total - offset;
+
+  return counts;
+}
+
+void distributed_queue::rebalance() {
+  for (auto& d : devices) {
+    auto& evnt = d->part.kernel_event;
+    if (evnt == nullptr || evnt->get() == nullptr ||
+        evnt->get_info<info::event::command_execution_status>() !=
+            CL_COMPLETE) {
+      continue;
+    }
+
+    auto start =
+        evnt->get_profiling_info<info::event_profiling::command_start>();
+    auto end = evnt->get_profiling_info<info::event_profiling::command_end>();
+    // Each kernel is only measured once
+    evnt = nullptr;
+    if (end <= start) {
+      continue;
+    }
+
+    auto measured = d->part.count * 1e9 / static_cast<double>(end - start);
+    if (d->is_measured) {
+      d->throughput = (1 - smoothing) * d->throughput + smoothing * measured;
+      continue;
+    }
+
+    // Devices not measured yet keep their ratio to this one
+    auto scale = measured / d->throughput;
+    for (auto& other : devices) {
+      if (!other->is_measured && other != d) {
+        other->throughput *= scale;
+      }
+    }
+    d->throughput = measured;
+    d->is_measured = true;
+  }
+}
+
+void distributed_queue::wait() {
+  for (auto& d : devices) {
+    d->q.wait();
+  }
+}
+
+void distributed_queue::wait_and_throw() {
+  for (auto& d : devices) {
+    d->q.wait_and_throw();
+  }
+}
+
+vector_class<device> distributed_queue::get_devices() const {
+  vector_class<device> result;
+  result.reserve(devices.size());
+  for (auto& d : devices) {
+    result.push_back(d->q.get_device());
+  }
+  return result;
+}
+
+vector_class<double> distributed_queue::get_shares() const {
+  double sum = 0;
+  for (auto& d : devices) {
+    sum += d->throughput;
+  }
+
+  vector_class<double> shares;
+  shares.reserve(devices.size());
+  for (auto& d : devices) {
+    shares.push_back(d->throughput / sum);
+  }
+  return shares;
+}
@@ -8,3 +8,8 @@ using namespace detail;
 void error::thrower::report_async(context* thrower, exception_list& list) {
   thrower->asyncHandler(list);
 }
+
+void error::thrower::add_async(exception_list& list,
+                               string_class description) {
+  list.list.push_back(async_exception(std::current_exception(), description));
+}
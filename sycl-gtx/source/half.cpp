@@ -0,0 +1,77 @@
+#include "SYCL/half.h"
+
+#include <cstdint>
+#include <cstring>
+
+using namespace cl::sycl;
+
+::cl_half half::from_float(float value) {
+  std::uint32_t x;
+  std::memcpy(&x, &value, sizeof(x));
+
+  std::uint32_t sign = (x >> 16) & 0x8000;
+  std::uint32_t abs = x & 0x7FFFFFFF;
+
+  // Infinity and NaN, which stays a quiet NaN
+  if (abs >= 0x7F800000) {
+    return static_cast<::cl_half>(sign | 0x7C00 |
+                                  (abs > 0x7F800000 ? 0x200 : 0));
+  }
+  // Rounds to 65520 or more
+  if (abs >= 0x477FF000) {
+    return static_cast<::cl_half>(sign | 0x7C00);
+  }
+
+  std::uint32_t result;
+  std::uint32_t remainder;
+  std::uint32_t halfway;
+
+  if (abs < 0x38800000) {
+    // Subnormal half, in units of 2^-24
+    if (abs < 0x33000000) {
+      return static_cast<::cl_half>(sign);
+    }
+    std::uint32_t shift = 126 - (abs >> 23);
+    std::uint32_t mantissa = (abs & 0x7FFFFF) | 0x800000;
+    result = mantissa >> shift;
+    remainder = mantissa & ((1u << shift) - 1);
+    halfway = 1u << (shift - 1);
+  } else {
+    // Rebias the exponent, a rounding carry goes into the exponent
+    result = (abs >> 13) - ((127 - 15) << 10);
+    remainder = abs & 0x1FFF;
+    halfway = 0x1000;
+  }
+
+  if (remainder > halfway || (remainder == halfway && (result & 1))) {
+    ++result;
+  }
+  return static_cast<::cl_half>(sign | result);
+}
+
+float half::to_float(::cl_half bits) {
+  std::uint32_t sign = static_cast<std::uint32_t>(bits & 0x8000) << 16;
+  std::uint32_t exponent = (bits >> 10) & 0x1F;
+  std::uint32_t mantissa = bits & 0x3FF;
+  std::uint32_t x;
+
+  if (exponent == 0x1F) {
+    x = sign | 0x7F800000 | (mantissa << 13);
+  } else if (exponent != 0) {
+    x = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+  } else if (mantissa == 0) {
+    x = sign;
+  } else {
+    // Subnormal half, normalized as float
+    exponent = 127 - 14;
+    while ((mantissa & 0x400) == 0) {
+      mantissa <<= 1;
+      --exponent;
+    }
+    x = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+  }
+
+  float value;
+  std::memcpy(&value, &x, sizeof(value));
+  return value;
+}
@@ -9,3 +9,11 @@ using namespace detail;
 context handler::get_context(queue* q) {
   return q->get_context();
 }
+
+string_class handler::get_compile_options(queue* q) {
+  return q->get_compile_options();
+}
+
+bool handler::is_kernel_fusion(queue* q) {
+  return q->get_kernel_fusion();
+}
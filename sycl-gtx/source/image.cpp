@@ -0,0 +1,151 @@
+#include "SYCL/image.h"
+
+#include "SYCL/detail/synchronizer.h"
+#include "SYCL/event.h"
+#include <cstring>
+
+using namespace cl::sycl;
+using detail::image_base;
+
+static cl_channel_order get_cl_order(image_channel_order order) {
+  switch (order) {
+    case image_channel_order::r:
+      return CL_R;
+    case image_channel_order::rg:
+      return CL_RG;
+    case image_channel_order::bgra:
+      return CL_BGRA;
+    case image_channel_order::argb:
+      return CL_ARGB;
+    case image_channel_order::intensity:
+      return CL_INTENSITY;
+    case image_channel_order::luminance:
+      return CL_LUMINANCE;
+    default:
+      return CL_RGBA;
+  }
+}
+
+static cl_channel_type get_cl_type(image_channel_type type) {
+  switch (type) {
+    case image_channel_type::snorm_int8:
+      return CL_SNORM_INT8;
+    case image_channel_type::snorm_int16:
+      return CL_SNORM_INT16;
+    case image_channel_type::unorm_int8:
+      return CL_UNORM_INT8;
+    case image_channel_type::unorm_int16:
+      return CL_UNORM_INT16;
+    case image_channel_type::signed_int8:
+      return CL_SIGNED_INT8;
+    case image_channel_type::signed_int16:
+      return CL_SIGNED_INT16;
+    case image_channel_type::signed_int32:
+      return CL_SIGNED_INT32;
+    case image_channel_type::unsigned_int8:
+      return CL_UNSIGNED_INT8;
+    case image_channel_type::unsigned_int16:
+      return CL_UNSIGNED_INT16;
+    case image_channel_type::unsigned_int32:
+      return CL_UNSIGNED_INT32;
+    case image_channel_type::fp16:
+      return CL_HALF_FLOAT;
+    default:
+      return CL_FLOAT;
+  }
+}
+
+static ::size_t get_num_channels(image_channel_order order) {
+  switch (order) {
+    case image_channel_order::r:
+    case image_channel_order::intensity:
+    case image_channel_order::luminance:
+      return 1;
+    case image_channel_order::rg:
+      return 2;
+    default:
+      return 4;
+  }
+}
+
+static ::size_t get_channel_size(image_channel_type type) {
+  switch (type) {
+    case image_channel_type::snorm_int8:
+    case image_channel_type::unorm_int8:
+    case image_channel_type::signed_int8:
+    case image_channel_type::unsigned_int8:
+      return 1;
+    case image_channel_type::snorm_int16:
+    case image_channel_type::unorm_int16:
+    case image_channel_type::signed_int16:
+    case image_channel_type::unsigned_int16:
+    case image_channel_type::fp16:
+      return 2;
+    default:
+      return 4;
+  }
+}
+
+image_base::image_base(void* host_data, bool is_read_only,
+                       image_channel_order order, image_channel_type type,
+                       int num_dimensions, region_t region)
+    : host_data(host_data, [](void* ptr) {}),
+      order(order),
+      type(type),
+      num_dimensions(num_dimensions),
+      region(region),
+      is_read_only(is_read_only) {}
+
+image_base::image_base(image_channel_order order, image_channel_type type,
+                       int num_dimensions, region_t region)
+    : image_base(nullptr, false, order, type, num_dimensions, region) {
+  host_data = shared_ptr_class<void>(new char[get_size()],
+                                     [](void* ptr) {
+                                       delete[] static_cast<char*>(ptr);
+                                     });
+  std::memset(host_data.get(), 0, get_size());
+}
+
+image_base::~image_base() {
+  synchronizer::submit_deferred(this);
+  event::wait_and_throw(events);
+}
+
+::size_t image_base::get_element_size() const {
+  return get_num_channels(order) * get_channel_size(type);
+}
+
+void image_base::create(queue* q, const vector_class<cl_event>& wait_events,
+                        image_base* img) {
+  cl_image_format format = {get_cl_order(img->order), get_cl_type(img->type)};
+
+  cl_image_desc desc = {};
+  desc.image_type = (img->num_dimensions == 2 ? CL_MEM_OBJECT_IMAGE2D
+                                               : CL_MEM_OBJECT_IMAGE3D);
+  desc.image_width = img->region[0];
+  desc.image_height = img->region[1];
+  desc.image_depth = img->region[2];
+
+  ::cl_int error_code;
+  img->device_data = buffer_base::cl_create_image(
+      q, img->is_read_only ? CL_MEM_READ_ONLY : CL_MEM_READ_WRITE, format,
+      desc, error_code);
+  detail::error::report(error_code);
+  img->device_data.release_one();
+}
+
+void image_base::init() {
+  if (!is_initialized) {
+    command::group_detail::add_buffer_init(create, __func__, this);
+    is_initialized = true;
+  }
+}
+
+void image_base::enqueue(queue* q, const vector_class<cl_event>& wait_events,
+                         clEnqueueBuffer_f clEnqueueBuffer) {
+  cl_event evnt;
+  auto error_code = this->cl_enqueue_image(
+      q, region.data(), host_data.get(), wait_events, evnt, clEnqueueBuffer);
+  detail::error::report(error_code);
+  events.emplace_back(evnt);
+}
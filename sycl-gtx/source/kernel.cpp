@@ -13,8 +13,9 @@ kernel::kernel(cl_kernel k)
       ctx(get_info<info::kernel::context>()),
       prog(new program(ctx, get_info<info::kernel::program>())) {}
 
-cl_event kernel::get_cl_event(event* evnt) {
-  return evnt->evnt.get();
+void kernel::set_cl_event(event* evnt, cl_event ev) {
+  evnt->evnt = ev;
+  evnt->evnt.release_one();
 }
 cl_command_queue kernel::get_cl_queue(queue* q) {
   return q->get();
@@ -22,12 +23,13 @@ cl_command_queue kernel::get_cl_queue(queue* q) {
 
 void kernel::enqueue_task(queue* q, const vector_class<cl_event>& wait_events,
                           event* evnt) const {
-  auto ev = evnt->evnt.get();
+  cl_event ev;
 
   auto error_code = clEnqueueTask(q->get(), kern.get(),
                                   static_cast<::cl_uint>(wait_events.size()),
                                   get_events_ptr(wait_events), &ev);
   detail::error::report(error_code);
+  set_cl_event(evnt, ev);
 }
 
 program kernel::get_program() const {
@@ -0,0 +1,144 @@
+#include "SYCL/mapped_file.h"
+
+#include "SYCL/error_handler.h"
+#include <cstdint>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace cl::sycl;
+
+static void report_failure() {
+  detail::error::report(detail::error::code::CANNOT_ACCESS_FILE);
+}
+
+mapped_file::mapped_file(const string_class& path, mode mapMode,
+                         ::size_t offset, ::size_t length)
+    : map_mode(mapMode) {
+#ifdef _WIN32
+  int fd = _open(path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+#endif
+  if (fd < 0) {
+    report_failure();
+  }
+
+  try {
+    map(fd, offset, length);
+  } catch (...) {
+#ifdef _WIN32
+    _close(fd);
+#else
+    close(fd);
+#endif
+    throw;
+  }
+
+#ifdef _WIN32
+  _close(fd);
+#else
+  close(fd);
+#endif
+}
+
+mapped_file::mapped_file(int fd, ::size_t offset, ::size_t length,
+                         mode mapMode)
+    : map_mode(mapMode) {
+  map(fd, offset, length);
+}
+
+#ifdef _WIN32
+
+void mapped_file::map(int fd, ::size_t offset, ::size_t size) {
+  auto file = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+  LARGE_INTEGER file_size;
+  if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &file_size) ||
+      offset > static_cast<std::uint64_t>(file_size.QuadPart)) {
+    report_failure();
+  }
+  if (size == 0) {
+    size = static_cast<::size_t>(file_size.QuadPart - offset);
+  }
+  if (size == 0 ||
+      offset + size > static_cast<std::uint64_t>(file_size.QuadPart)) {
+    report_failure();
+  }
+
+  // Views start at a multiple of the allocation granularity
+  SYSTEM_INFO system;
+  GetSystemInfo(&system);
+  std::uint64_t start = offset / system.dwAllocationGranularity *
+                        system.dwAllocationGranularity;
+  auto skip = static_cast<::size_t>(offset - start);
+
+  bool is_copy = (map_mode == mode::copy_on_write);
+  auto handle = CreateFileMapping(file, nullptr,
+                                  is_copy ? PAGE_WRITECOPY : PAGE_READONLY, 0,
+                                  0, nullptr);
+  if (handle == nullptr) {
+    report_failure();
+  }
+  auto base = MapViewOfFile(handle, is_copy ? FILE_MAP_COPY : FILE_MAP_READ,
+                            static_cast<DWORD>(start >> 32),
+                            static_cast<DWORD>(start & 0xFFFFFFFF),
+                            size + skip);
+  // The view keeps the mapping open
+  CloseHandle(handle);
+  if (base == nullptr) {
+    report_failure();
+  }
+
+  shared_ptr_class<void> view(base, [](void* ptr) { UnmapViewOfFile(ptr); });
+  mapping = shared_ptr_class<void>(view, static_cast<char*>(base) + skip);
+  length = size;
+}
+
+#else
+
+void mapped_file::map(int fd, ::size_t offset, ::size_t size) {
+  struct stat info;
+  if (fstat(fd, &info) != 0 ||
+      offset > static_cast<std::uint64_t>(info.st_size)) {
+    report_failure();
+  }
+  if (size == 0) {
+    size = static_cast<::size_t>(info.st_size - offset);
+  }
+  if (size == 0 || offset + size > static_cast<std::uint64_t>(info.st_size)) {
+    report_failure();
+  }
+
+  // Mappings start at a page boundary
+  auto page = static_cast<::size_t>(sysconf(_SC_PAGESIZE));
+  auto start = offset / page * page;
+  auto skip = offset - start;
+  auto span = size + skip;
+
+  // Private mappings never write to the file
+  int protection = PROT_READ;
+  if (map_mode == mode::copy_on_write) {
+    protection |= PROT_WRITE;
+  }
+  auto base = mmap(nullptr, span, protection, MAP_PRIVATE, fd,
+                   static_cast<off_t>(start));
+  if (base == MAP_FAILED) {
+    report_failure();
+  }
+  // Buffers read the file from start to end
+  posix_madvise(base, span, POSIX_MADV_SEQUENTIAL);
+
+  shared_ptr_class<void> pages(base, [span](void* ptr) { munmap(ptr, span); });
+  mapping = shared_ptr_class<void>(pages, static_cast<char*>(base) + skip);
+  length = size;
+}
+
+#endif
@@ -8,6 +8,7 @@
 using namespace cl::sycl;
 
 vector_class<platform> platform::platforms;
+mutex_class platform::platforms_mutex;
 
 platform::platform(cl_platform_id platform_id, device_selector& dev_selector)
     : platform_id(platform_id) {}
@@ -23,8 +24,8 @@ cl_platform_id platform::get() const {
 }
 
 vector_class<platform> platform::get_platforms() {
+  std::lock_guard<mutex_class> lock(platforms_mutex);
   if (platforms.empty()) {
-    // TODO(progtx): Thread safe
     static const int MAX_PLATFORMS = 1024;
     cl_platform_id platform_ids[MAX_PLATFORMS];
     cl_uint num_platforms;
@@ -22,11 +22,15 @@ program::program(const context& context, cl_program clProgram)
 void program::compile(string_class compile_options, ::size_t kernel_name_id,
                       shared_ptr_class<kernel> kern) {
   kernels.emplace(kernel_name_id, kern);
+  build_options = compile_options;
   auto& src = kern->src;
   auto code = src.get_code();
 
   debug() << "Compiled kernel:";
   debug() << code;
+  if (!compile_options.empty()) {
+    debug() << "Compile options:" << compile_options;
+  }
 
   const char* code_p = code.c_str();
   ::size_t length = code.size();
@@ -120,3 +124,7 @@ void program::link(string_class linking_options) {
 
   linked = true;
 }
+
+string_class program::get_build_options() const {
+  return build_options;
+}
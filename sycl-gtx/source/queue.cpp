@@ -1,6 +1,8 @@
 #include "SYCL/queue.h"
 
 #include "SYCL/buffer_base.h"
+#include "SYCL/command_graph.h"
+#include "SYCL/handler.h"
 
 using namespace cl::sycl;
 
@@ -37,7 +39,7 @@ cl_command_queue queue::create_queue(bool display_info,
 
 queue::queue(const async_handler& asyncHandler)
     : ctx(asyncHandler),
-      dev(ctx.get_devices()[0]),
+      dev(detail::default_device_selector()->select_device(ctx.get_devices())),
       command_q(create_queue()),
       command_group(this) {
   command_q.release_one();
@@ -46,7 +48,7 @@ queue::queue(const async_handler& asyncHandler)
 queue::queue(const device_selector& deviceSelector,
              const async_handler& asyncHandler)
     : ctx(deviceSelector, false, asyncHandler),
-      dev(ctx.get_devices()[0]),
+      dev(deviceSelector.select_device(ctx.get_devices())),
       command_q(create_queue()),
       command_group(this) {
   command_q.release_one();
@@ -75,7 +77,7 @@ queue::queue(const context& syclContext, const device& syclDevice,
              const async_handler& asyncHandler)
     : ctx(syclContext.get(), asyncHandler),
       dev(syclDevice),
-      command_q(create_queue(profilingFlag)),
+      command_q(create_queue(true, true, profilingFlag)),
       command_group(this) {
   command_q.release_one();
 }
@@ -124,6 +126,82 @@ device queue::get_device() const {
   return dev;
 }
 
+void queue::set_compile_options(string_class compile_options) {
+  compile_opts = std::move(compile_options);
+}
+
+string_class queue::get_compile_options() const {
+  return compile_opts;
+}
+
+void queue::set_kernel_fusion(bool enable) {
+  kernel_fusion = enable;
+  if (!enable) {
+    flush_deferred();
+  }
+}
+
+bool queue::get_kernel_fusion() const {
+  return kernel_fusion;
+}
+
+void queue::set_submission_window(::size_t groups) {
+  set_flush_policy(flush_policy::every(groups));
+}
+
+::size_t queue::get_submission_window() const {
+  return policy.groups;
+}
+
+void queue::set_flush_policy(flush_policy flushPolicy) {
+  policy = flushPolicy;
+  if (is_window_full()) {
+    flush_window();
+  }
+}
+
+flush_policy queue::get_flush_policy() const {
+  return policy;
+}
+
+void queue::set_transfer_overlap(bool enable) {
+  if (!enable) {
+    transfer_q = nullptr;
+  } else if (transfer_q.get() == nullptr) {
+    transfer_q = create_queue(false, false);
+    transfer_q.release_one();
+  }
+}
+
+bool queue::get_transfer_overlap() const {
+  return transfer_q.get() != nullptr;
+}
+
+void queue::begin_recording() {
+  // Held back kernels belong to earlier groups
+  flush_deferred();
+  recording = std::make_shared<command_graph>();
+}
+
+command_graph queue::end_recording() {
+  if (recording == nullptr) {
+    detail::error::report(detail::error::code::NOT_RECORDING);
+  }
+  flush_deferred();
+  auto graph = std::move(*recording);
+  recording.reset();
+  graph.plan();
+  return graph;
+}
+
+bool queue::is_recording() const {
+  return recording != nullptr;
+}
+
+handler_event queue::replay(command_graph& graph) {
+  return submit([&graph](handler&) { graph.issue(); });
+}
+
 /**
  * Checks to see if any asynchronous errors have been produced by the queue
  * and if so reports them by passing them to the async_handler
@@ -131,23 +209,38 @@ device queue::get_device() const {
  * If no async_handler was provided then asynchronous exceptions will be lost.
  */
 void queue::throw_asynchronous() {
-  if (ex_list.size() > 0) {
-    detail::error::thrower::report_async(&ctx, ex_list);
+  // Moved from
+  if (ex_list == nullptr) {
+    return;
+  }
+  exception_list list;
+  {
+    std::lock_guard<mutex_class> guard(ex_list->lock);
+    std::swap(list, ex_list->list);
+  }
+  if (list.size() > 0) {
+    detail::error::thrower::report_async(&ctx, list);
   }
 }
 
 void queue::wait() {
+  flush_deferred();
+  flush_window();
   finish();
   wait_subqueues(false);
 }
 
 void queue::wait_and_throw() {
+  flush_deferred();
+  flush_window();
   finish();
   wait_subqueues(true);
   throw_asynchronous();
 }
 
 void queue::flush() {
+  flush_deferred();
+  flush_window();
   for (auto& q : subqueues) {
     q.process(buffers_in_use);
   }
@@ -158,6 +251,17 @@ void queue::finish() {
     auto error_code = clFinish(command_q.get());
     detail::error::report(error_code);
   }
+  if (transfer_q.get() != nullptr) {
+    auto error_code = clFinish(transfer_q.get());
+    detail::error::report(error_code);
+  }
+}
+
+cl_command_queue queue::get_copy_queue() {
+  if (is_transferring && transfer_q.get() != nullptr) {
+    return transfer_q.get();
+  }
+  return command_q.get();
 }
 
 void queue::wait_subqueues(bool and_throw) {
@@ -170,6 +274,93 @@ void queue::wait_subqueues(bool and_throw) {
   }
 }
 
+handler_event queue::submit_deferred() {
+  auto group = &subqueues.back().command_group;
+  if (deferred >= 0 && subqueues[deferred].command_group.fuse(*group)) {
+    subqueues.pop_back();
+    group = &subqueues[deferred].command_group;
+  } else {
+    flush_deferred();
+    if (group->deferred == nullptr) {
+      return schedule(subqueues.back());
+    }
+    deferred = static_cast<int>(subqueues.size()) - 1;
+  }
+
+  track_buffers(*group);
+  return handler_event();
+}
+
+void queue::flush_deferred() {
+  if (deferred < 0) {
+    return;
+  }
+  auto& q = subqueues[deferred];
+  deferred = -1;
+  q.command_group.issue_deferred();
+  schedule(q);
+}
+
+handler_event queue::schedule(queue& subqueue) {
+  if (recording != nullptr) {
+    subqueue.command_group.optimize();
+    recording->record(subqueue.command_group);
+  }
+
+  if (policy.groups == 1) {
+    return subqueue.process(buffers_in_use);
+  }
+
+  if (window_groups == 0) {
+    window_start = std::chrono::steady_clock::now();
+  }
+  auto& group = subqueue.command_group;
+  group.optimize();
+  command_group.append(group);
+  track_buffers(command_group);
+  subqueue.is_flushed = true;
+
+  ++window_groups;
+  if (is_window_full()) {
+    flush_window();
+  }
+  return handler_event();
+}
+
+void queue::flush_window() {
+  if (window_groups == 0 ||
+      !detail::synchronizer::can_flush(command_group.read_buffers) ||
+      !detail::synchronizer::can_flush(command_group.write_buffers)) {
+    return;
+  }
+  command_group.optimize_window();
+  command_group.flush(
+      get_wait_events(command_group.read_buffers, buffers_in_use));
+  buffers_in_use.insert(command_group.write_buffers.begin(),
+                        command_group.write_buffers.end());
+  command_group.read_buffers.clear();
+  command_group.write_buffers.clear();
+  window_groups = 0;
+}
+
+bool queue::is_window_full() const {
+  if (window_groups == 0) {
+    return false;
+  }
+  if (policy.groups > 0 && window_groups >= policy.groups) {
+    return true;
+  }
+  return policy.interval.count() > 0 &&
+         std::chrono::steady_clock::now() - window_start >= policy.interval;
+}
+
+// Lets the synchronizer find the queue before the buffers are used
+void queue::track_buffers(const detail::command_group& group) {
+  buffers_in_use.insert(group.read_buffers.begin(), group.read_buffers.end());
+  buffers_in_use.insert(group.write_buffers.begin(),
+                        group.write_buffers.end());
+}
+
 handler_event queue::process(buffer_set& buffers_in_use_master) {
   if (is_flushed ||
       !detail::synchronizer::can_flush(command_group.read_buffers) ||
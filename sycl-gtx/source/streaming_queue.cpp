@@ -0,0 +1,35 @@
+#include "SYCL/streaming_queue.h"
+
+using namespace cl::sycl;
+
+streaming_queue::streaming_queue(::size_t chunkSize, ::size_t depth,
+                                 const async_handler& asyncHandler)
+    : q(asyncHandler),
+      chunk_size(std::max<::size_t>(chunkSize, 1)),
+      chunks(std::max<::size_t>(depth, 1)) {
+  q.set_transfer_overlap(true);
+}
+
+streaming_queue::streaming_queue(const context& syclContext,
+                                 const device& syclDevice, ::size_t chunkSize,
+                                 ::size_t depth,
+                                 const async_handler& asyncHandler)
+    : q(syclContext, syclDevice, asyncHandler),
+      chunk_size(std::max<::size_t>(chunkSize, 1)),
+      chunks(std::max<::size_t>(depth, 1)) {
+  q.set_transfer_overlap(true);
+}
+
+void streaming_queue::wait() {
+  q.wait();
+  for (auto& part : chunks) {
+    part = {};
+  }
+}
+
+void streaming_queue::wait_and_throw() {
+  q.wait_and_throw();
+  for (auto& part : chunks) {
+    part = {};
+  }
+}
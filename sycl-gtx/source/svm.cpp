@@ -0,0 +1,83 @@
+#include "SYCL/svm.h"
+
+#ifdef CL_VERSION_2_0
+
+#include "SYCL/device.h"
+#include "SYCL/queue.h"
+
+using namespace cl::sycl;
+using namespace detail;
+
+svm_base::svm_base(queue& q, ::size_t size, svm_mode grain)
+    : ctx(q.get_context()),
+      map_q(q.get()),
+      pointer(nullptr),
+      size(size),
+      grain(grain) {
+  cl_device_svm_capabilities capabilities = 0;
+  auto error_code =
+      clGetDeviceInfo(q.get_device().get(), CL_DEVICE_SVM_CAPABILITIES,
+                      sizeof(capabilities), &capabilities, nullptr);
+  detail::error::report(error_code);
+
+  cl_svm_mem_flags flags = CL_MEM_READ_WRITE;
+  cl_device_svm_capabilities required = CL_DEVICE_SVM_COARSE_GRAIN_BUFFER;
+  if (grain == svm_mode::fine_grain) {
+    flags |= CL_MEM_SVM_FINE_GRAIN_BUFFER;
+    required = CL_DEVICE_SVM_FINE_GRAIN_BUFFER;
+  }
+  if ((capabilities & required) == 0) {
+    detail::error::report(CL_INVALID_OPERATION);
+  }
+
+  pointer = clSVMAlloc(ctx.get(), flags, size, 0);
+  if (pointer == nullptr) {
+    detail::error::report(CL_MEM_OBJECT_ALLOCATION_FAILURE);
+  }
+}
+
+svm_base::~svm_base() {
+  synchronizer::submit_deferred(this);
+  event::wait_and_throw(events);
+  if (pointer != nullptr) {
+    clSVMFree(ctx.get(), pointer);
+  }
+}
+
+void svm_base::map(bool is_read_only) {
+  // Without copies, the kernels are the last commands using the allocation
+  auto wait_events = synchronizer::request(this);
+  if (grain == svm_mode::fine_grain) {
+    event::wait_and_throw(wait_events);
+    return;
+  }
+
+  vector_class<cl_event> cl_events;
+  cl_events.reserve(wait_events.size());
+  for (auto& ev : wait_events) {
+    cl_events.push_back(ev.get());
+  }
+  cl_map_flags flags = CL_MAP_READ;
+  if (!is_read_only) {
+    flags |= CL_MAP_WRITE;
+  }
+  auto error_code = clEnqueueSVMMap(
+      map_q.get(), CL_TRUE, flags, pointer, size,
+      static_cast<::cl_uint>(cl_events.size()),
+      cl_events.empty() ? nullptr : cl_events.data(), nullptr);
+  detail::error::report(error_code);
+}
+
+void svm_base::unmap() {
+  if (grain == svm_mode::fine_grain) {
+    return;
+  }
+  cl_event evnt;
+  auto error_code = clEnqueueSVMUnmap(map_q.get(), pointer, 0, nullptr, &evnt);
+  detail::error::report(error_code);
+  // Kernels using the allocation next wait for the unmap
+  events.emplace_back(evnt);
+  clReleaseEvent(evnt);
+}
+
+#endif  // CL_VERSION_2_0
@@ -0,0 +1,123 @@
+#include "SYCL/trace_memo.h"
+
+#include "SYCL/command_group.h"
+#include "SYCL/detail/partition.h"
+#include "SYCL/kernel.h"
+#include "SYCL/program.h"
+
+using namespace cl::sycl;
+using namespace detail;
+
+void trace_memo::clear() {
+  trace_memo_registry::clear();
+}
+
+std::set<::size_t> trace_memo_registry::enabled;
+std::map<trace_memo_registry::key_t, trace_memo_registry::entry>
+    trace_memo_registry::entries;
+mutex_class trace_memo_registry::m;
+
+void trace_memo_registry::enable(::size_t kernel_name_id, bool enable) {
+  std::lock_guard<mutex_class> lock(m);
+  if (enable) {
+    enabled.insert(kernel_name_id);
+  } else {
+    enabled.erase(kernel_name_id);
+  }
+}
+
+bool trace_memo_registry::is_enabled(::size_t kernel_name_id) {
+  std::lock_guard<mutex_class> lock(m);
+  return enabled.count(kernel_name_id) > 0;
+}
+
+void trace_memo_registry::clear() {
+  std::lock_guard<mutex_class> lock(m);
+  entries.clear();
+}
+
+// Modes, targets and buffer ranges of the accessors, which all have a buffer,
+// along with the first accessor of the same buffer.
+// Ranges are part of the traced indexing of multi-dimensional buffers,
+// element types are fixed by the kernel type.
+// Partition slices are rebased in the kernel.
+string_class trace_memo_registry::get_signature(
+    const vector_class<buffer_access>& accs) {
+  auto part = partition::current;
+  string_class signature;
+  for (::size_t i = 0; i < accs.size(); ++i) {
+    ::size_t first = 0;
+    while (accs[first].data != accs[i].data) {
+      ++first;
+    }
+    signature += get_string<int>::get(static_cast<int>(accs[i].mode)) + ',' +
+                 get_string<int>::get(static_cast<int>(accs[i].target)) +
+                 ',' + get_string<::size_t>::get(first);
+    for (int n = 0; n < 3; ++n) {
+      signature +=
+          ',' + get_string<::size_t>::get(accs[i].data->access_range(n));
+    }
+    if (part != nullptr && part->is_slice(accs[i].data)) {
+      signature += ",slice";
+    }
+    signature += ';';
+  }
+  return signature;
+}
+
+shared_ptr_class<kernel> trace_memo_registry::get(
+    ::size_t kernel_type_id, cl_context ctx,
+    const string_class& compile_options,
+    const function_class<shared_ptr_class<kernel>()>& build) {
+  auto accessors = command::group_detail::get_accessors();
+  for (auto& acc : accessors) {
+    // Local accessors need to be traced for their size
+    if (acc.data == nullptr) {
+      return build();
+    }
+  }
+  key_t key(kernel_type_id, ctx, compile_options, get_signature(accessors));
+
+  {
+    std::lock_guard<mutex_class> lock(m);
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+      vector_class<buffer_base*> buffers;
+      for (auto position : it->second.positions) {
+        buffers.push_back(accessors[position].data);
+      }
+      auto kern = std::make_shared<kernel>(*it->second.kern);
+      kern->src.rebind(buffers);
+      // Arguments are set on the kernel object when it is enqueued,
+      // so submissions cannot share one
+      ::cl_int error_code;
+      auto k = clCreateKernel(kern->prog->get(),
+                              kern->src.get_kernel_name().c_str(), &error_code);
+      detail::error::report(error_code);
+      kern->set(k);
+      kern->kern.release_one();
+      return kern;
+    }
+  }
+
+  auto kern = build();
+
+  entry e{kern, {}};
+  for (auto buf : kern->src.get_buffers()) {
+    ::size_t position = 0;
+    while (position < accessors.size() && accessors[position].data != buf) {
+      ++position;
+    }
+    if (position == accessors.size()) {
+      // Cannot be bound to the buffers of later submissions
+      return kern;
+    }
+    e.positions.push_back(position);
+  }
+
+  // The returned kernel can be bound to other buffers later
+  e.kern = std::make_shared<kernel>(*kern);
+  std::lock_guard<mutex_class> lock(m);
+  entries.emplace(std::move(key), std::move(e));
+  return kern;
+}
@@ -0,0 +1,41 @@
+#include "../common.h"
+
+// Reading a buffer back while the host works on other data
+
+using namespace cl::sycl;
+
+int main() {
+  static const int N = 1024;
+
+  queue myQueue;
+  buffer<int> squares(N);
+
+  myQueue.submit([&](handler& cgh) {
+    auto out = squares.get_access<access::mode::discard_write>(cgh);
+    cgh.parallel_for<class square>(range<1>(N),
+                                   [=](id<1> i) { out[i] = i * i; });
+  });
+
+  auto readback = squares.get_access_async<access::mode::read>();
+
+  // Host work overlapping the transfer
+  vector_class<int> cubes(N);
+  for (int i = 0; i < N; ++i) {
+    cubes[i] = i * i * i;
+  }
+
+  auto out = readback.get();
+  if (!readback.is_ready()) {
+    debug() << "readback not complete after get";
+    return 1;
+  }
+
+  for (int i = 0; i < N; ++i) {
+    if (out[i] * i != cubes[i]) {
+      debug() << i << "expected" << i * i << "actual" << out[i];
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,95 @@
+#include "../common.h"
+
+// Device memory of runtime managed buffers is recycled,
+// transfers can go through pinned host memory
+
+using namespace cl::sycl;
+
+int main() {
+  static const int N = 1000;
+  static const int frames = 4;
+
+  queue myQueue;
+  auto ctx = myQueue.get_context();
+
+  for (int frame = 0; frame < frames; ++frame) {
+    auto colors = buffer<int>(range<1>(N));
+    {
+      auto c = colors.get_access<access::mode::discard_write,
+                                 access::target::host_buffer>();
+      std::fill(c.begin(), c.end(), frame);
+    }
+
+    myQueue.submit([&](handler& cgh) {
+      auto c = colors.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for<class pooled>(range<1>(N),
+                                     [=](id<1> i) { c[i] += i[0]; });
+    });
+
+    auto c =
+        colors.get_access<access::mode::read, access::target::host_buffer>();
+    for (int i = 0; i < N; ++i) {
+      if (c[i] != frame + i) {
+        debug() << frame << i << "expected" << frame + i << "actual" << c[i];
+        return 1;
+      }
+    }
+  }
+
+  auto s = buffer_pool::get_stats(ctx);
+  auto size = detail::memory_pool::size_class(N * sizeof(int));
+  if (s.allocations != 1 || s.reuses != frames - 1 || s.bytes_in_use != 0 ||
+      s.bytes_cached != size || s.peak_bytes != size) {
+    debug() << "Unexpected pool statistics" << s.allocations << s.reuses
+            << s.bytes_in_use << s.bytes_cached << s.peak_bytes;
+    return 1;
+  }
+
+  // The pool belongs to the OpenCL context, not to one context object
+  if (buffer_pool::get_stats(context(ctx.get())).allocations != 1 ||
+      buffer_pool::get_stats(context()).allocations != 0) {
+    debug() << "Pool is not shared by the context objects";
+    return 1;
+  }
+
+  buffer_pool::set_limit(ctx, 0);
+  if (buffer_pool::get_stats(ctx).bytes_cached != 0) {
+    debug() << "Pool was not trimmed to the limit";
+    return 1;
+  }
+
+  // Transfers through pinned host memory
+  buffer_pool::set_pinned_host(ctx);
+  vector_class<int> user_data(N, 1);
+  {
+    buffer<int> user(user_data.data(), range<1>(N));
+    auto shadowed = buffer<int>(range<1>(N));
+
+    myQueue.submit([&](handler& cgh) {
+      auto u = user.get_access<access::mode::read_write>(cgh);
+      auto s = shadowed.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class pinned>(range<1>(N), [=](id<1> i) {
+        s[i] = u[i] + i[0];
+        u[i] += 1;
+      });
+    });
+
+    auto s =
+        shadowed.get_access<access::mode::read, access::target::host_buffer>();
+    for (int i = 0; i < N; ++i) {
+      if (s[i] != i + 1) {
+        debug() << i << "expected" << i + 1 << "actual" << s[i];
+        return 1;
+      }
+    }
+  }
+
+  for (int i = 0; i < N; ++i) {
+    if (user_data[i] != 2) {
+      debug() << i << "expected 2 actual" << user_data[i];
+      return 1;
+    }
+  }
+
+  return 0;
+}
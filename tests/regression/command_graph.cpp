@@ -0,0 +1,68 @@
+#include "../common.h"
+
+// Command groups recorded once and replayed
+
+using namespace cl::sycl;
+
+int main() {
+  static const int N = 1024;
+  static const int iterations = 5;
+
+  queue myQueue;
+
+  vector_class<float> a(N, 1), b(N, 0), c(N, 10), d(N, 0);
+
+  {
+    buffer<float> A(a.data(), range<1>(N));
+    buffer<float> B(b.data(), range<1>(N));
+    buffer<float> C(c.data(), range<1>(N));
+    buffer<float> D(d.data(), range<1>(N));
+
+    myQueue.begin_recording();
+    myQueue.submit([&](handler& cgh) {
+      auto a = A.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for<class increment>(range<1>(N), [=](id<1> i) {
+        a[i] += 1;
+      });
+    });
+    myQueue.submit([&](handler& cgh) {
+      auto a = A.get_access<access::mode::read>(cgh);
+      auto b = B.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for<class accumulate>(range<1>(N), [=](id<1> i) {
+        b[i] += a[i];
+      });
+    });
+    auto graph = myQueue.end_recording();
+
+    if (graph.get_num_groups() != 2 || myQueue.is_recording()) {
+      debug() << "recorded" << graph.get_num_groups() << "groups";
+      return 1;
+    }
+
+    // The recording already executed the first iteration
+    for (int it = 1; it < iterations; ++it) {
+      myQueue.replay(graph);
+    }
+
+    // Same commands on other buffers
+    graph.rebind(A, C);
+    graph.rebind(B, D);
+    myQueue.replay(graph);
+  }
+
+  // a = 1 + iterations, b = 2 + 3 + ... + (1 + iterations)
+  float expected_b = 0;
+  for (int it = 1; it <= iterations; ++it) {
+    expected_b += 1 + it;
+  }
+
+  for (int i = 0; i < N; ++i) {
+    if (a[i] != 1 + iterations || b[i] != expected_b || c[i] != 11 ||
+        d[i] != 11) {
+      debug() << i << "actual" << a[i] << b[i] << c[i] << d[i];
+      return 1;
+    }
+  }
+
+  return 0;
+}
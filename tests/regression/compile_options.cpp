@@ -0,0 +1,66 @@
+#include "../common.h"
+
+// Kernels compiled with relaxed math compile options
+
+int main() {
+  using namespace cl::sycl;
+
+  static const int N = 1024;
+  static const float TOL = 0.001f;
+  float h_a[N];
+  float h_r[N];
+  float h_q[N];
+
+  for (int i = 0; i < N; ++i) {
+    h_a[i] = static_cast<float>(i) / N;
+  }
+
+  compile_options::set<class relaxed_mad>(compile_options::mad_enable);
+  if (compile_options::get<class relaxed_mad>() != "-cl-mad-enable") {
+    debug() << "Kernel name compile options were not stored";
+    return 1;
+  }
+
+  {
+    buffer<float> d_a(h_a, range<1>(N));
+    buffer<float> d_r(h_r, range<1>(N));
+    buffer<float> d_q(h_q, range<1>(N));
+
+    queue myQueue;
+    myQueue.set_compile_options(compile_options::fast_math());
+
+    myQueue.submit([&](handler& cgh) {
+      auto a = d_a.get_access<access::mode::read>(cgh);
+      auto r = d_r.get_access<access::mode::discard_write>(cgh);
+
+      cgh.parallel_for<class relaxed_mad>(range<1>(N), [=](id<1> i) {
+        r[i] = a[i] * a[i] + a[i];
+      });
+    });
+
+    myQueue.submit([&](handler& cgh) {
+      auto a = d_a.get_access<access::mode::read>(cgh);
+      auto q = d_q.get_access<access::mode::discard_write>(cgh);
+
+      cgh.parallel_for<class relaxed_sqrt>(
+          range<1>(N), [=](id<1> i) { q[i] = sqrt(a[i]); });
+    });
+  }
+
+  compile_options::reset<class relaxed_mad>();
+
+  for (int i = 0; i < N; ++i) {
+    auto expected = h_a[i] * h_a[i] + h_a[i];
+    if (std::fabs(h_r[i] - expected) > TOL) {
+      debug() << i << h_r[i] << "!=" << expected;
+      return 1;
+    }
+    expected = std::sqrt(h_a[i]);
+    if (std::fabs(h_q[i] - expected) > TOL) {
+      debug() << i << h_q[i] << "!=" << expected;
+      return 1;
+    }
+  }
+
+  return 0;
+}
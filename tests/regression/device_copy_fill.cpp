@@ -0,0 +1,92 @@
+#include "../common.h"
+
+// Buffers filled and copied by the device, without kernels
+
+using namespace cl::sycl;
+
+int main() {
+  static const int N = 256;
+  static const float value = 3.5f;
+
+  queue myQueue;
+  vector_class<float> result(N, 0);
+  vector_class<float> read_back(N, 0);
+  vector_class<float> kernel_result(N, 0);
+  vector_class<float> updated(N, 0);
+
+  {
+    buffer<float> a(N);
+    buffer<float> b(result.data(), range<1>(N));
+
+    myQueue.submit([&](handler& cgh) {
+      auto acc = a.get_access<access::mode::discard_write>(cgh);
+      cgh.fill(acc, value);
+    });
+
+    myQueue.submit([&](handler& cgh) {
+      auto src = a.get_access<access::mode::read>(cgh);
+      auto dst = b.get_access<access::mode::discard_write>(cgh);
+      cgh.copy(src, dst);
+    });
+
+    myQueue.submit([&](handler& cgh) {
+      auto src = a.get_access<access::mode::read>(cgh);
+      cgh.copy(src, read_back.data());
+    });
+
+    myQueue.wait();
+  }
+
+  {
+    // Operations traced after a kernel of the same group run after it,
+    // even when the kernel is held back for fusion
+    queue fusionQueue;
+    fusionQueue.set_kernel_fusion(true);
+    buffer<float> c(N);
+    buffer<float> d(updated.data(), range<1>(N));
+
+    fusionQueue.submit([&](handler& cgh) {
+      auto cw = c.get_access<access::mode::discard_write>(cgh);
+      auto dw = d.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class fill_c>(range<1>(N), [=](id<1> i) {
+        cw[i] = value;
+        dw[i] = value;
+      });
+      cgh.copy(cw, kernel_result.data());
+      cgh.update_host(dw);
+    });
+
+    fusionQueue.wait();
+  }
+
+  for (int i = 0; i < N; ++i) {
+    if (result[i] != value) {
+      debug() << "copy" << i << "expected" << value << "actual" << result[i];
+      return 1;
+    }
+  }
+  for (int i = 0; i < N; ++i) {
+    if (read_back[i] != value) {
+      debug() << "read back" << i << "expected" << value << "actual"
+              << read_back[i];
+      return 1;
+    }
+  }
+
+  for (int i = 0; i < N; ++i) {
+    if (kernel_result[i] != value) {
+      debug() << "copy after kernel" << i << "expected" << value << "actual"
+              << kernel_result[i];
+      return 1;
+    }
+  }
+  for (int i = 0; i < N; ++i) {
+    if (updated[i] != value) {
+      debug() << "update after kernel" << i << "expected" << value
+              << "actual" << updated[i];
+      return 1;
+    }
+  }
+
+  return 0;
+}
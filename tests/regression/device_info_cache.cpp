@@ -0,0 +1,80 @@
+#include "../common.h"
+#include <set>
+#include <sstream>
+
+// Cached device information matches the OpenCL queries
+
+using namespace cl::sycl;
+
+static string_class query_string(cl_device_id id, cl_device_info param) {
+  ::size_t size = 0;
+  clGetDeviceInfo(id, param, 0, nullptr, &size);
+  vector_class<char> value(size + 1, '\0');
+  clGetDeviceInfo(id, param, size, value.data(), nullptr);
+  return string_class(value.data());
+}
+
+int main() {
+  auto devices = device::get_devices();
+  if (devices.empty()) {
+    debug() << "No devices";
+    return 1;
+  }
+
+  for (auto& dev : devices) {
+    if (dev.is_host()) {
+      continue;
+    }
+    auto id = dev.get();
+
+    auto name = query_string(id, CL_DEVICE_NAME);
+    auto extensions = query_string(id, CL_DEVICE_EXTENSIONS);
+    ::cl_uint compute_units = 0;
+    clGetDeviceInfo(id, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(compute_units),
+                    &compute_units, nullptr);
+
+    // The first query fills the cache, the second reads it
+    for (int query = 0; query < 2; ++query) {
+      if (dev.get_info<info::device::name>() != name) {
+        debug() << "Device name" << dev.get_info<info::device::name>()
+                << "!=" << name;
+        return 1;
+      }
+      if (dev.get_info<info::device::extensions>() != extensions) {
+        debug() << "Device extensions differ from the OpenCL query";
+        return 1;
+      }
+      if (dev.get_info<info::device::max_compute_units>() != compute_units) {
+        debug() << "Compute units"
+                << dev.get_info<info::device::max_compute_units>()
+                << "!=" << compute_units;
+        return 1;
+      }
+    }
+
+    std::istringstream names(extensions);
+    std::set<string_class> listed;
+    string_class extension;
+    while (names >> extension) {
+      listed.insert(extension);
+    }
+    for (auto& ext : listed) {
+      if (!dev.has_extension(ext)) {
+        debug() << "Missing extension" << ext;
+        return 1;
+      }
+      // Prefixes of an extension are not extensions themselves
+      auto prefix = ext.substr(0, ext.length() - 1);
+      if (dev.has_extension(prefix) != (listed.count(prefix) != 0)) {
+        debug() << "Prefix" << prefix << "taken for an extension";
+        return 1;
+      }
+    }
+    if (dev.has_extension("cl_sycl_gtx_not_an_extension")) {
+      debug() << "Unknown extension reported";
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,45 @@
+#include "../common.h"
+
+// Built-in selectors score devices, the benchmark ranking is cached
+
+using namespace cl::sycl;
+
+int main() {
+  auto devices = device::get_devices();
+  if (devices.empty()) {
+    debug() << "No devices";
+    return 1;
+  }
+
+  default_selector def;
+  gpu_selector gpu;
+  cpu_selector cpu;
+  benchmark_selector bench;
+
+  for (auto& dev : devices) {
+    auto score = def(dev);
+    if (score < 0) {
+      continue;
+    }
+    if ((gpu(dev) >= 0) != dev.is_gpu() || (cpu(dev) >= 0) != dev.is_cpu()) {
+      debug() << "Device type not respected by selector";
+      return 1;
+    }
+    if (bench(dev) != bench(dev)) {
+      debug() << "Benchmark ranking not cached";
+      return 1;
+    }
+  }
+
+  // The selected device has the highest score
+  queue myQueue(bench);
+  auto best = bench(myQueue.get_device());
+  for (auto& dev : myQueue.get_context().get_devices()) {
+    if (bench(dev) > best) {
+      debug() << "Better device available" << bench(dev) << best;
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include "../common.h"
+
+// Kernels split across all devices of the context
+
+using namespace cl::sycl;
+
+int main() {
+  static const int N = 4096;
+  static const int width = 64;
+  static const int height = 96;
+  static const int iterations = 3;
+
+  distributed_queue dq;
+
+  vector_class<float> a(N), b(N), c(N, 0);
+  for (int i = 0; i < N; ++i) {
+    a[i] = static_cast<float>(i);
+    b[i] = static_cast<float>(2 * i);
+  }
+  vector_class<int> image(width * height, 0);
+
+  {
+    buffer<float> A(a.data(), range<1>(N));
+    buffer<float> B(b.data(), range<1>(N));
+    buffer<float> C(c.data(), range<1>(N));
+    buffer<int, 2> img(image.data(), range<2>(width, height));
+
+    // Parts move between devices as throughput gets measured
+    for (int it = 0; it < iterations; ++it) {
+      dq.submit(range<1>(N), [&](handler& cgh) {
+        auto a = A.get_access<access::mode::read>(cgh);
+        auto b = B.get_access<access::mode::read>(cgh);
+        auto c = C.get_access<access::mode::read_write>(cgh);
+        cgh.parallel_for<class vector_add>(range<1>(N), [=](id<1> i) {
+          c[i] += a[i] + b[i];
+        });
+      });
+    }
+
+    dq.submit(range<2>(width, height), [&](handler& cgh) {
+      auto i = img.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class rows>(range<2>(width, height), [=](id<2> idx) {
+        i[idx] = idx[1] * width + idx[0];
+      });
+    });
+
+    // Half of each row is strided in storage
+    bool reported = false;
+    try {
+      buffer<int, 2> half(img, id<2>(0, 0), range<2>(width / 2, height));
+    } catch (exception&) {
+      reported = true;
+    }
+    if (!reported) {
+      debug() << "Non-contiguous sub-buffer was not reported";
+      return 1;
+    }
+  }
+
+  for (int i = 0; i < N; ++i) {
+    auto expected = iterations * 3.0f * i;
+    if (c[i] != expected) {
+      debug() << i << "expected" << expected << "actual" << c[i];
+      return 1;
+    }
+  }
+  for (int i = 0; i < width * height; ++i) {
+    if (image[i] != i) {
+      debug() << i << "expected" << i << "actual" << image[i];
+      return 1;
+    }
+  }
+
+  auto shares = dq.get_shares();
+  if (shares.size() != dq.get_devices().size()) {
+    debug() << "Missing device shares";
+    return 1;
+  }
+
+  return 0;
+}
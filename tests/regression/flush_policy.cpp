@@ -0,0 +1,63 @@
+#include "../common.h"
+
+// Command groups flushed in batches
+
+using namespace cl::sycl;
+
+int main() {
+  static const int N = 256;
+  static const int iterations = 8;
+
+  queue myQueue;
+  myQueue.set_flush_policy(flush_policy::on_synchronization());
+  if (myQueue.get_submission_window() != 0) {
+    debug() << "expected no limit on the number of groups";
+    return 1;
+  }
+
+  vector_class<int> a(N, 0), b(N, 0);
+
+  {
+    buffer<int> A(a.data(), range<1>(N));
+    buffer<int> B(b.data(), range<1>(N));
+
+    // Nothing is flushed until the host accesses A
+    for (int it = 0; it < iterations; ++it) {
+      myQueue.submit([&](handler& cgh) {
+        auto a = A.get_access<access::mode::read_write>(cgh);
+        cgh.parallel_for<class increment>(range<1>(N), [=](id<1> i) {
+          a[i] += 1;
+        });
+      });
+    }
+    {
+      auto host_a =
+          A.get_access<access::mode::read, access::target::host_buffer>();
+      if (host_a[N - 1] != iterations) {
+        debug() << "expected" << iterations << "actual" << host_a[N - 1];
+        return 1;
+      }
+    }
+
+    // Flushed on the first submission after the interval
+    myQueue.set_flush_policy(
+        flush_policy::every(flush_policy::microseconds(100)));
+    for (int it = 0; it < iterations; ++it) {
+      myQueue.submit([&](handler& cgh) {
+        auto b = B.get_access<access::mode::read_write>(cgh);
+        cgh.parallel_for<class increment_b>(range<1>(N), [=](id<1> i) {
+          b[i] += 2;
+        });
+      });
+    }
+  }
+
+  for (int i = 0; i < N; ++i) {
+    if (a[i] != iterations || b[i] != 2 * iterations) {
+      debug() << i << "actual" << a[i] << b[i];
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include "../common.h"
+
+// Buffers of half, computed in half or in float depending on the device
+
+using namespace cl::sycl;
+
+static bool check_bits(float value, unsigned short expected) {
+  auto bits = half(value).get_bits();
+  if (bits != expected) {
+    debug() << value << "expected bits" << expected << "actual" << bits;
+    return false;
+  }
+  return true;
+}
+
+int main() {
+  static const int N = 64;
+
+  if (!check_bits(1.0f, 0x3C00) || !check_bits(-2.0f, 0xC000) ||
+      !check_bits(0.1f, 0x2E66) || !check_bits(65504.0f, 0x7BFF) ||
+      !check_bits(65520.0f, 0x7C00) || !check_bits(5.96046448e-8f, 0x0001) ||
+      !check_bits(1e-8f, 0x0000)) {
+    return 1;
+  }
+  if (static_cast<float>(half::from_bits(0x3555)) != 0.333251953125f) {
+    debug() << "Wrong conversion from half to float";
+    return 1;
+  }
+
+  queue myQueue;
+
+  vector_class<half> in(N);
+  vector_class<half> out(N, half(0.0f));
+  vector_class<cl::sycl::cl_half4> in4(N);
+  vector_class<cl::sycl::cl_half4> out4(N);
+  for (int i = 0; i < N; ++i) {
+    in[i] = half(i * 0.5f);
+    in4[i].x() = half(static_cast<float>(i));
+    in4[i].y() = half(-i * 0.25f);
+    in4[i].z() = half(1.0f);
+    in4[i].w() = half(0.0f);
+  }
+
+  {
+    buffer<half> a(in.data(), range<1>(N));
+    buffer<half> b(out.data(), range<1>(N));
+    buffer<cl::sycl::cl_half4> a4(in4.data(), range<1>(N));
+    buffer<cl::sycl::cl_half4> b4(out4.data(), range<1>(N));
+
+    myQueue.submit([&](handler& cgh) {
+      auto ai = a.get_access<access::mode::read>(cgh);
+      auto bi = b.get_access<access::mode::discard_write>(cgh);
+      auto ai4 = a4.get_access<access::mode::read>(cgh);
+      auto bi4 = b4.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class half_scale>(range<1>(N), [=](id<1> i) {
+        bi[i] = ai[i] * 2.0f;
+        half4 v = ai4[i];
+        bi4[i] = v + v;
+      });
+    });
+  }
+
+  for (int i = 0; i < N; ++i) {
+    float expected = static_cast<float>(i);
+    if (out[i] != expected) {
+      debug() << i << "expected" << expected << "actual"
+              << static_cast<float>(out[i]);
+      return 1;
+    }
+    auto& e = in4[i];
+    auto& r = out4[i];
+    if (r.x() != 2 * e.x() || r.y() != 2 * e.y() || r.z() != 2 * e.z()) {
+      debug() << i << "expected" << 2 * e.x() << 2 * e.y() << 2 * e.z()
+              << "actual" << static_cast<float>(r.x())
+              << static_cast<float>(r.y()) << static_cast<float>(r.z());
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,69 @@
+#include "../common.h"
+#include <cstring>
+
+// Host accessor raw pointers, iterators and row pointers
+
+using namespace cl::sycl;
+
+int main() {
+  const size_t X = 16;
+  const size_t Y = 8;
+  const size_t Z = 4;
+
+  buffer<int, 3> A(range<3>(X, Y, Z));
+  buffer<int> B(range<1>(X * Y * Z));
+
+  {
+    auto ah = A.get_access<access::mode::discard_write,
+                           access::target::host_buffer>();
+    if (ah.size() != X * Y * Z || ah.end() != ah.begin() + X * Y * Z) {
+      debug() << "Wrong host accessor size" << ah.size();
+      return 1;
+    }
+    for (size_t z = 0; z < Z; ++z) {
+      for (size_t y = 0; y < Y; ++y) {
+        auto row = ah.row(y, z);
+        for (size_t x = 0; x < X; ++x) {
+          row[x] = static_cast<int>(x + 100 * y + 10000 * z);
+        }
+      }
+    }
+  }
+
+  {
+    auto ah = A.get_access<access::mode::read, access::target::host_buffer>();
+    for (size_t x = 0; x < X; ++x) {
+      for (size_t y = 0; y < Y; ++y) {
+        for (size_t z = 0; z < Z; ++z) {
+          auto expected = static_cast<int>(x + 100 * y + 10000 * z);
+          if (ah[x][y][z] != expected) {
+            debug() << x << y << z << "expected" << expected << "actual"
+                    << ah[x][y][z];
+            return 1;
+          }
+        }
+      }
+    }
+
+    auto bh = B.get_access<access::mode::discard_write,
+                           access::target::host_buffer>();
+    std::copy(ah.begin(), ah.end(), bh.begin());
+  }
+
+  vector_class<int> result(X * Y * Z);
+  {
+    auto bh = B.get_access<access::mode::read, access::target::host_buffer>();
+    std::memcpy(result.data(), bh.data(), bh.size() * sizeof(int));
+  }
+
+  for (size_t i = 0; i < result.size(); ++i) {
+    auto expected = static_cast<int>(i % X + 100 * (i / X % Y) +
+                                     10000 * (i / (X * Y)));
+    if (result[i] != expected) {
+      debug() << i << "expected" << expected << "actual" << result[i];
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,108 @@
+#include "../common.h"
+
+// Host code between two kernels, without blocking the submitting thread
+
+using namespace cl::sycl;
+
+int main() {
+  static const int N = 512;
+
+  queue myQueue;
+  vector_class<int> result(N, 0);
+
+  {
+    buffer<int> a(N);
+    buffer<int> b(N);
+    buffer<int> c(result.data(), range<1>(N));
+
+    myQueue.submit([&](handler& cgh) {
+      auto out = a.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class produce>(range<1>(N),
+                                      [=](id<1> i) { out[i] = i; });
+    });
+
+    myQueue.submit([&](handler& cgh) {
+      auto in = a.get_access<access::mode::read>(cgh);
+      auto out = b.get_access<access::mode::discard_write>(cgh);
+      cgh.host_task([=]() {
+        auto src = in.get_host_pointer();
+        auto dst = out.get_host_pointer();
+        for (int i = 0; i < N; ++i) {
+          dst[i] = src[i] * 2;
+        }
+      });
+    });
+
+    myQueue.submit([&](handler& cgh) {
+      auto in = b.get_access<access::mode::read>(cgh);
+      auto out = c.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class consume>(range<1>(N),
+                                      [=](id<1> i) { out[i] = in[i] + 1; });
+    });
+  }
+
+  for (int i = 0; i < N; ++i) {
+    if (result[i] != 2 * i + 1) {
+      debug() << i << "expected" << 2 * i + 1 << "actual" << result[i];
+      return 1;
+    }
+  }
+
+  // Host task in the same group as a kernel using local memory
+  static const int group_size = 64;
+  vector_class<int> copied(N, 0);
+  {
+    buffer<int> a(N);
+
+    myQueue.submit([&](handler& cgh) {
+      auto out = a.get_access<access::mode::discard_write>(cgh);
+      accessor<int, 1, access::mode::read_write, access::target::local> tile(
+          group_size, cgh);
+      cgh.parallel_for<class through_local>(
+          nd_range<1>(N, group_size), [=](nd_item<1> index) {
+            auto lid = index.get_local(0);
+            tile[lid] = index.get_global(0);
+            index.barrier(access::fence_space::local_space);
+            out[index.get_global(0)] = tile[lid];
+          });
+      cgh.host_task([=, &copied]() {
+        auto src = out.get_host_pointer();
+        for (int i = 0; i < N; ++i) {
+          copied[i] = src[i];
+        }
+      });
+    });
+
+    myQueue.wait();
+  }
+
+  for (int i = 0; i < N; ++i) {
+    if (copied[i] != i) {
+      debug() << "local" << i << "expected" << i << "actual" << copied[i];
+      return 1;
+    }
+  }
+
+  // Exceptions of host tasks are reported to the asynchronous handler
+  int reported = 0;
+  {
+    queue failingQueue([&](exception_list list) {
+      for (auto& e : list) {
+        try {
+          std::rethrow_exception(e);
+        } catch (int value) {
+          reported = value;
+        }
+      }
+    });
+    failingQueue.submit(
+        [&](handler& cgh) { cgh.host_task([]() { throw 7; }); });
+    failingQueue.wait_and_throw();
+  }
+  if (reported != 7) {
+    debug() << "host task exception not reported";
+    return 1;
+  }
+
+  return 0;
+}
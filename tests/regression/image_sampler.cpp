@@ -0,0 +1,97 @@
+#include "../common.h"
+
+// Images read through a sampler and written by a kernel
+
+using namespace cl::sycl;
+
+int main() {
+  static const int width = 32;
+  static const int height = 16;
+  static const int N = width * height;
+
+  queue myQueue;
+
+  vector_class<float> in(4 * N);
+  vector_class<float> out(4 * N, 0);
+  for (int i = 0; i < 4 * N; ++i) {
+    in[i] = static_cast<float>(i);
+  }
+
+  {
+    image<2> src(in.data(), image_channel_order::rgba,
+                 image_channel_type::fp32, range<2>(width, height));
+    image<2> dst(out.data(), image_channel_order::rgba,
+                 image_channel_type::fp32, range<2>(width, height));
+
+    if (src.get_size() != 4 * N * sizeof(float)) {
+      debug() << "image takes" << src.get_size() << "bytes";
+      return 1;
+    }
+
+    myQueue.submit([&](handler& cgh) {
+      auto s = src.get_access<float4, access::mode::read>(cgh);
+      auto d = dst.get_access<float4, access::mode::discard_write>(cgh);
+      sampler smpl(coordinate_normalization_mode::unnormalized,
+                   addressing_mode::clamp_to_edge, filtering_mode::linear);
+
+      cgh.parallel_for<class resample>(range<2>(width, height), [=](id<2> i) {
+        // Sampling at the center of the pixel returns the pixel itself
+        float2 coords(i[0] + 0.5f, i[1] + 0.5f);
+        float4 pixel = s.read(coords, smpl);
+        d.write(i, pixel * 2.0f - s.read(i));
+      });
+    });
+  }
+
+  for (int i = 0; i < 4 * N; ++i) {
+    if (out[i] != in[i]) {
+      debug() << i << "expected" << in[i] << "actual" << out[i];
+      return 1;
+    }
+  }
+
+  // Pixels written and read through host accessors
+  {
+    image<2> src(image_channel_order::rgba, image_channel_type::fp32,
+                 range<2>(width, height));
+    image<2> dst(image_channel_order::rgba, image_channel_type::fp32,
+                 range<2>(width, height));
+
+    {
+      auto acc = src.get_access<float4, access::mode::discard_write>();
+      for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+          cl::sycl::cl_float4 pixel;
+          pixel.x() = static_cast<float>(x);
+          pixel.y() = static_cast<float>(y);
+          pixel.z() = 0;
+          pixel.w() = 1;
+          acc.write(id<2>(x, y), pixel);
+        }
+      }
+    }
+
+    myQueue.submit([&](handler& cgh) {
+      auto s = src.get_access<float4, access::mode::read>(cgh);
+      auto d = dst.get_access<float4, access::mode::discard_write>(cgh);
+      cgh.parallel_for<class scale_pixels>(
+          range<2>(width, height),
+          [=](id<2> i) { d.write(i, s.read(i) * 2.0f); });
+    });
+
+    auto acc = dst.get_access<float4, access::mode::read>();
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        auto pixel = acc.read(id<2>(x, y));
+        if (pixel.x() != 2.0f * x || pixel.y() != 2.0f * y ||
+            pixel.w() != 2.0f) {
+          debug() << x << y << "expected" << 2.0f * x << 2.0f * y << "actual"
+                  << pixel.x() << pixel.y();
+          return 1;
+        }
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include "../common.h"
+
+// Adjacent range kernels fused into one
+
+using namespace cl::sycl;
+
+int main() {
+  static const int N = 1024;
+
+  queue myQueue;
+  myQueue.set_kernel_fusion(true);
+
+  vector_class<float> a(N), b(N), c(N), d(N), e(N);
+
+  {
+    buffer<float> A(a.data(), range<1>(N));
+    buffer<float> B(b.data(), range<1>(N));
+    buffer<float> C(c.data(), range<1>(N));
+    buffer<float> D(d.data(), range<1>(N));
+    buffer<float> E(e.data(), range<1>(N));
+
+    // Init, transform and scale become one kernel
+    myQueue.submit([&](handler& cgh) {
+      auto a = A.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class init>(range<1>(N), [=](id<1> i) {
+        a[i] = i[0];
+      });
+    });
+    myQueue.submit([&](handler& cgh) {
+      auto a = A.get_access<access::mode::read>(cgh);
+      auto b = B.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class transform>(range<1>(N), [=](id<1> i) {
+        b[i] = a[i] + 1;
+      });
+    });
+    myQueue.submit([&](handler& cgh) {
+      auto b = B.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for<class scale>(range<1>(N), [=](id<1> i) {
+        b[i] *= 2;
+      });
+    });
+
+    // Same range, but reads other elements than its own
+    myQueue.submit([&](handler& cgh) {
+      auto b = B.get_access<access::mode::read>(cgh);
+      auto d = D.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class reverse>(range<1>(N), [=](id<1> i) {
+        d[i] = b[N - 1 - i[0]];
+      });
+    });
+
+    // Reads neighbors of the previous output, so it cannot be fused
+    myQueue.submit([&](handler& cgh) {
+      auto b = B.get_access<access::mode::read>(cgh);
+      auto c = C.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class shift>(range<1>(N - 1), [=](id<1> i) {
+        c[i] = b[i + 1];
+      });
+    });
+
+    // The task runs after the range kernel traced before it
+    myQueue.submit([&](handler& cgh) {
+      auto e = E.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for<class fill_e>(range<1>(N), [=](id<1> i) {
+        e[i] = 3;
+      });
+      cgh.single_task<class sum_e>([=]() { e[0] = e[0] + e[N - 1]; });
+    });
+  }
+
+  for (int i = 0; i < N; ++i) {
+    auto expected = 2.0f * (i + 1);
+    if (b[i] != expected) {
+      debug() << i << "expected" << expected << "actual" << b[i];
+      return 1;
+    }
+    if (i < N - 1 && c[i] != 2.0f * (i + 2)) {
+      debug() << i << "expected" << 2.0f * (i + 2) << "actual" << c[i];
+      return 1;
+    }
+    if (d[i] != 2.0f * (N - i)) {
+      debug() << i << "expected" << 2.0f * (N - i) << "actual" << d[i];
+      return 1;
+    }
+    auto expected_e = (i == 0) ? 6.0f : 3.0f;
+    if (e[i] != expected_e) {
+      debug() << i << "expected" << expected_e << "actual" << e[i];
+      return 1;
+    }
+  }
+
+  return 0;
+}
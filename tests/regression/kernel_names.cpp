@@ -0,0 +1,87 @@
+#include "../common.h"
+
+// Kernel names and variables derived from the kernel contents
+
+using namespace cl::sycl;
+
+struct traced {
+  string_class code;
+  string_class name;
+};
+
+template <class KernelType>
+static traced trace(KernelType kern) {
+  auto src = detail::kernel_ns::constructor<id<1>>::get(kern);
+  return {src.get_code(), src.get_kernel_name()};
+}
+
+int main() {
+  static const int N = 256;
+
+  queue myQueue;
+
+  vector_class<float> in(N), out(N, 0);
+  for (int i = 0; i < N; ++i) {
+    in[i] = static_cast<float>(i);
+  }
+
+  vector_class<traced> scaled;
+  traced shifted;
+
+  {
+    buffer<float> A(in.data(), range<1>(N));
+    buffer<float> B(out.data(), range<1>(N));
+
+    for (int group = 0; group < 2; ++group) {
+      myQueue.submit([&](handler& cgh) {
+        auto a = A.get_access<access::mode::read>(cgh);
+        auto b = B.get_access<access::mode::discard_write>(cgh);
+        auto scale = [=](id<1> i) {
+          cl::sycl::float1 x = a[i];
+          b[i] = x * 2;
+        };
+        // Traced twice in the same group
+        scaled.push_back(trace(scale));
+        scaled.push_back(trace(scale));
+        cgh.parallel_for<class scale>(range<1>(N), scale);
+      });
+    }
+
+    myQueue.submit([&](handler& cgh) {
+      auto a = A.get_access<access::mode::read>(cgh);
+      auto b = B.get_access<access::mode::discard_write>(cgh);
+      shifted = trace([=](id<1> i) {
+        cl::sycl::float1 x = a[i];
+        b[i] = x + 2;
+      });
+    });
+  }
+
+  for (auto& t : scaled) {
+    if (t.code != scaled[0].code) {
+      debug() << "Kernel source differs between traces";
+      debug() << scaled[0].code;
+      debug() << t.code;
+      return 1;
+    }
+    if (t.name != scaled[0].name) {
+      debug() << "Kernel name" << t.name << "!=" << scaled[0].name;
+      return 1;
+    }
+  }
+
+  if (shifted.name == scaled[0].name) {
+    debug() << "Different kernels named" << shifted.name;
+    return 1;
+  }
+
+  for (int i = 0; i < N; ++i) {
+    auto expected = in[i] * 2;
+    if (out[i] != expected) {
+      debug() << i << "expected" << expected << "actual" << out[i];
+      return 1;
+    }
+  }
+
+  return 0;
+}
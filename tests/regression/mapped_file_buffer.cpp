@@ -0,0 +1,79 @@
+#include "../common.h"
+#include <cstdio>
+#include <fstream>
+
+// Buffer using a file mapped into memory, written back to a file
+
+using namespace cl::sycl;
+
+int main() {
+  static const int N = 1024;
+  static const char* in_path = "mapped_file_buffer.in";
+  static const char* out_path = "mapped_file_buffer.out";
+
+  {
+    vector_class<float> data(N);
+    for (int i = 0; i < N; ++i) {
+      data[i] = static_cast<float>(i);
+    }
+    std::ofstream file(in_path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(data.data()),
+               N * sizeof(float));
+  }
+
+  {
+    queue myQueue;
+    mapped_file file(in_path, mapped_file::mode::copy_on_write);
+    buffer<float> buf(file);
+
+    if (buf.get_count() != N) {
+      debug() << "mapped" << buf.get_count() << "elements";
+      return 1;
+    }
+
+    myQueue.submit([&](handler& cgh) {
+      auto data = buf.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for<class twice>(range<1>(N),
+                                    [=](id<1> i) { data[i] = data[i] * 2; });
+    });
+
+    buf.set_final_data(out_path);
+  }
+
+  {
+    // Results written back over the mapped file itself
+    queue myQueue;
+    mapped_file file(out_path, mapped_file::mode::copy_on_write);
+    buffer<float> buf(file);
+
+    myQueue.submit([&](handler& cgh) {
+      auto data = buf.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for<class add_one>(range<1>(N),
+                                      [=](id<1> i) { data[i] = data[i] + 1; });
+    });
+
+    buf.set_final_data(out_path);
+  }
+
+  vector_class<float> original(N), result(N);
+  std::ifstream(in_path, std::ios::binary)
+      .read(reinterpret_cast<char*>(original.data()), N * sizeof(float));
+  std::ifstream(out_path, std::ios::binary)
+      .read(reinterpret_cast<char*>(result.data()), N * sizeof(float));
+  std::remove(in_path);
+  std::remove(out_path);
+
+  for (int i = 0; i < N; ++i) {
+    // Copy-on-write leaves the mapped file unchanged
+    if (original[i] != i) {
+      debug() << "file changed at" << i << original[i];
+      return 1;
+    }
+    if (result[i] != 2.0f * i + 1) {
+      debug() << i << "expected" << 2.0f * i + 1 << "actual" << result[i];
+      return 1;
+    }
+  }
+
+  return 0;
+}
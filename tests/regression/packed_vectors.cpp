@@ -0,0 +1,49 @@
+#include "../common.h"
+
+// Packed 3-element vectors loaded and stored with vload3 and vstore3
+
+using namespace cl::sycl;
+
+int main() {
+  static const int N = 64;
+
+  if (sizeof(packed_float3) != 3 * sizeof(float)) {
+    debug() << "packed_float3 takes" << sizeof(packed_float3) << "bytes";
+    return 1;
+  }
+
+  queue myQueue;
+
+  vector_class<packed_float3> in(N);
+  vector_class<packed_float3> out(N, packed_float3(0, 0, 0));
+  for (int i = 0; i < N; ++i) {
+    in[i] = packed_float3(i, i + 0.5f, -i);
+  }
+
+  {
+    buffer<packed_float3> a(in.data(), range<1>(N));
+    buffer<packed_float3> b(out.data(), range<1>(N));
+
+    myQueue.submit([&](handler& cgh) {
+      auto ai = a.get_access<access::mode::read>(cgh);
+      auto bi = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class scale>(range<1>(N), [=](id<1> i) {
+        float3 v = ai[i];
+        bi[i] = v * 2.0f;
+        bi[i] += float3(1, 1, 1);
+      });
+    });
+  }
+
+  for (int i = 0; i < N; ++i) {
+    auto& e = in[i];
+    auto& r = out[i];
+    if (r.x != 2 * e.x + 1 || r.y != 2 * e.y + 1 || r.z != 2 * e.z + 1) {
+      debug() << i << "expected" << 2 * e.x + 1 << 2 * e.y + 1 << 2 * e.z + 1
+              << "actual" << r.x << r.y << r.z;
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,64 @@
+#include "../common.h"
+
+// Array of structures stored as a structure of arrays
+
+using namespace cl::sycl;
+
+struct particle {
+  float mass;
+  int charge;
+  float energy;
+  // Not stored in the buffer
+  int tag;
+};
+
+int main() {
+  static const int N = 128;
+
+  queue myQueue;
+
+  vector_class<particle> particles(N);
+  for (int i = 0; i < N; ++i) {
+    particles[i] = {static_cast<float>(i), i % 3 - 1, 0, i};
+  }
+
+  {
+    soa_buffer<particle, 1, float, int, float> buf(
+        particles.data(), range<1>(N), &particle::mass, &particle::charge,
+        &particle::energy);
+
+    {
+      auto acc = buf.get_access<access::mode::read>();
+      for (int i = 0; i < N; ++i) {
+        particle p = acc[i];
+        if (p.mass != particles[i].mass || acc[i].get<1>() != i % 3 - 1) {
+          debug() << i << "not scattered into the fields";
+          return 1;
+        }
+      }
+    }
+
+    myQueue.submit([&](handler& cgh) {
+      auto p = buf.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for<class energy>(range<1>(N), [=](id<1> i) {
+        auto e = p[i];
+        e.get<2>() = e.get<0>() * e.get<1>();
+      });
+    });
+  }
+
+  for (int i = 0; i < N; ++i) {
+    auto expected = static_cast<float>(i * (i % 3 - 1));
+    if (particles[i].energy != expected) {
+      debug() << i << "expected" << expected << "actual"
+              << particles[i].energy;
+      return 1;
+    }
+    if (particles[i].tag != i) {
+      debug() << i << "undescribed field overwritten";
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,72 @@
+#include "../common.h"
+
+// Kernels streamed through the device in chunks
+
+using namespace cl::sycl;
+
+static int num_traced = 0;
+
+int main() {
+  static const int N = 4000;
+  static const int width = 32;
+  static const int height = 50;
+
+  streaming_queue sq(768, 3);
+  trace_memo::enable<class stream_add>();
+
+  vector_class<float> a(N), b(N), c(N, 0);
+  for (int i = 0; i < N; ++i) {
+    a[i] = static_cast<float>(i);
+    b[i] = static_cast<float>(3 * i);
+  }
+  vector_class<int> image(width * height, 0);
+
+  {
+    buffer<float> A(a.data(), range<1>(N));
+    buffer<float> B(b.data(), range<1>(N));
+    buffer<float> C(c.data(), range<1>(N));
+    buffer<int, 2> img(image.data(), range<2>(width, height));
+
+    sq.submit(range<1>(N), [&](handler& cgh) {
+      auto a = A.get_access<access::mode::read>(cgh);
+      auto b = B.get_access<access::mode::read>(cgh);
+      auto c = C.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class stream_add>(range<1>(N), [=](id<1> i) {
+        // Only runs while the kernel is traced
+        ++num_traced;
+        c[i] = a[i] + b[i];
+      });
+    });
+
+    // Chunks of whole rows
+    sq.submit(range<2>(width, height), [&](handler& cgh) {
+      auto i = img.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class stream_rows>(
+          range<2>(width, height),
+          [=](id<2> idx) { i[idx] = idx[1] * width + idx[0]; });
+    });
+
+    sq.wait();
+  }
+
+  // Every chunk has the same kernel
+  if (num_traced != 1) {
+    debug() << "kernel traced" << num_traced << "times";
+    return 1;
+  }
+
+  for (int i = 0; i < N; ++i) {
+    if (c[i] != 4.0f * i) {
+      debug() << i << "expected" << 4.0f * i << "actual" << c[i];
+      return 1;
+    }
+  }
+  for (int i = 0; i < width * height; ++i) {
+    if (image[i] != i) {
+      debug() << i << "expected" << i << "actual" << image[i];
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,57 @@
+#include "../common.h"
+
+// Command groups gathered and flushed together
+
+using namespace cl::sycl;
+
+int main() {
+  static const int N = 1024;
+  static const int iterations = 6;
+
+  queue myQueue;
+  myQueue.set_submission_window(4);
+
+  vector_class<float> a(N, 1), b(N, 0), c(N, 0);
+
+  {
+    buffer<float> A(a.data(), range<1>(N));
+    buffer<float> B(b.data(), range<1>(N));
+    buffer<float> C(c.data(), range<1>(N));
+
+    // B is read back and written to the device again after each group
+    for (int it = 0; it < iterations; ++it) {
+      myQueue.submit([&](handler& cgh) {
+        auto a = A.get_access<access::mode::read>(cgh);
+        auto b = B.get_access<access::mode::read_write>(cgh);
+        cgh.parallel_for<class accumulate>(range<1>(N), [=](id<1> i) {
+          b[i] += a[i];
+        });
+      });
+    }
+
+    myQueue.submit([&](handler& cgh) {
+      auto c = C.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class independent>(range<1>(N), [=](id<1> i) {
+        c[i] = i[0];
+      });
+    });
+
+    // Host access flushes the window
+    auto host_b =
+        B.get_access<access::mode::read, access::target::host_buffer>();
+    if (host_b[N - 1] != iterations) {
+      debug() << "expected" << iterations << "actual" << host_b[N - 1];
+      return 1;
+    }
+  }
+
+  for (int i = 0; i < N; ++i) {
+    if (b[i] != iterations || c[i] != i) {
+      debug() << i << "expected" << iterations << i << "actual" << b[i]
+              << c[i];
+      return 1;
+    }
+  }
+
+  return 0;
+}
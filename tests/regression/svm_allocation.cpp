@@ -0,0 +1,59 @@
+#include "../common.h"
+
+// Shared virtual memory used by kernels without buffer copies
+
+using namespace cl::sycl;
+
+int main() {
+#ifdef CL_VERSION_2_0
+  static const int N = 64;
+
+  queue myQueue;
+
+  cl_device_svm_capabilities capabilities = 0;
+  clGetDeviceInfo(myQueue.get_device().get(), CL_DEVICE_SVM_CAPABILITIES,
+                  sizeof(capabilities), &capabilities, nullptr);
+  if ((capabilities & CL_DEVICE_SVM_COARSE_GRAIN_BUFFER) == 0) {
+    debug() << "Device doesn't support shared virtual memory";
+    return 0;
+  }
+
+  svm_allocation<float> a(myQueue, N);
+  svm_allocation<float> b(myQueue, N);
+  // Only reached through the pointer stored in it
+  svm_allocation<float*> table(myQueue, 1);
+
+  {
+    auto ah = a.get_access<access::mode::discard_write>();
+    for (int i = 0; i < N; ++i) {
+      ah[i] = static_cast<float>(i);
+    }
+    table.get_access<access::mode::discard_write>()[0] = a.get();
+  }
+
+  myQueue.submit([&](handler& cgh) {
+    auto ap = a.get_pointer<access::mode::read>(cgh);
+    auto bp = b.get_pointer<access::mode::discard_write>(cgh);
+    table.require<access::mode::read>(cgh);
+    cgh.parallel_for<class svm_copy>(range<1>(N),
+                                     [=](id<1> i) { bp[i] = ap[i]; });
+  });
+  myQueue.submit([&](handler& cgh) {
+    auto ap = a.get_pointer<access::mode::read>(cgh);
+    auto bp = b.get_pointer<access::mode::read_write>(cgh);
+    cgh.parallel_for<class svm_add>(range<1>(N),
+                                    [=](id<1> i) { bp[i] += ap[i]; });
+  });
+
+  auto bh = b.get_access<access::mode::read>();
+  for (int i = 0; i < N; ++i) {
+    float expected = 2.0f * i;
+    if (bh[i] != expected) {
+      debug() << i << "expected" << expected << "actual" << bh[i];
+      return 1;
+    }
+  }
+#endif
+
+  return 0;
+}
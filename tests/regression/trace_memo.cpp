@@ -0,0 +1,134 @@
+#include "../common.h"
+
+// Kernel traced once and rebound to other buffers
+
+using namespace cl::sycl;
+
+static int num_traced = 0;
+
+int main() {
+  static const int N = 256;
+  static const int parts = 3;
+
+  queue myQueue;
+  trace_memo::enable<class scale>();
+
+  vector_class<vector_class<float>> in(parts, vector_class<float>(N));
+  vector_class<vector_class<float>> out(parts, vector_class<float>(N, 0));
+  for (int p = 0; p < parts; ++p) {
+    for (int i = 0; i < N; ++i) {
+      in[p][i] = static_cast<float>(p * N + i);
+    }
+  }
+
+  {
+    vector_class<buffer<float>> ins, outs;
+    for (int p = 0; p < parts; ++p) {
+      ins.emplace_back(in[p].data(), range<1>(N));
+      outs.emplace_back(out[p].data(), range<1>(N));
+    }
+
+    for (int p = 0; p < parts; ++p) {
+      myQueue.submit([&](handler& cgh) {
+        auto a = ins[p].get_access<access::mode::read>(cgh);
+        auto b = outs[p].get_access<access::mode::discard_write>(cgh);
+        cgh.parallel_for<class scale>(range<1>(N), [=](id<1> i) {
+          // Only runs while the kernel is traced
+          ++num_traced;
+          b[i] = a[i] * 2;
+        });
+      });
+    }
+  }
+
+  if (num_traced != 1) {
+    debug() << "kernel traced" << num_traced << "times";
+    return 1;
+  }
+
+  for (int p = 0; p < parts; ++p) {
+    for (int i = 0; i < N; ++i) {
+      auto expected = 2.0f * (p * N + i);
+      if (out[p][i] != expected) {
+        debug() << p << i << "expected" << expected << "actual" << out[p][i];
+        return 1;
+      }
+    }
+  }
+
+  // Indexing of multi-dimensional buffers is traced with their range
+  static const int shapes[][2] = {{32, 8}, {8, 32}};
+  trace_memo::enable<class copy_2d>();
+  num_traced = 0;
+  for (auto& shape : shapes) {
+    range<2> r(shape[0], shape[1]);
+    vector_class<float> src(N), dst(N, 0);
+    for (int i = 0; i < N; ++i) {
+      src[i] = static_cast<float>(i);
+    }
+
+    {
+      buffer<float, 2> a(src.data(), r);
+      buffer<float, 2> b(dst.data(), r);
+      myQueue.submit([&](handler& cgh) {
+        auto ra = a.get_access<access::mode::read>(cgh);
+        auto wb = b.get_access<access::mode::discard_write>(cgh);
+        cgh.parallel_for<class copy_2d>(r, [=](id<2> i) {
+          ++num_traced;
+          wb[i] = ra[i];
+        });
+      });
+    }
+
+    for (int i = 0; i < N; ++i) {
+      if (dst[i] != src[i]) {
+        debug() << shape[0] << 'x' << shape[1] << i << "expected" << src[i]
+                << "actual" << dst[i];
+        return 1;
+      }
+    }
+  }
+  if (num_traced != 2) {
+    debug() << "2D kernel traced" << num_traced << "times";
+    return 1;
+  }
+
+  // Kernels with local accessors are traced on every submission
+  static const int group_size = 64;
+  trace_memo::enable<class local_copy>();
+  num_traced = 0;
+  vector_class<float> local_out(N, 0);
+  {
+    buffer<float> a(in[0].data(), range<1>(N));
+    buffer<float> b(local_out.data(), range<1>(N));
+    for (int p = 0; p < 2; ++p) {
+      myQueue.submit([&](handler& cgh) {
+        auto ra = a.get_access<access::mode::read>(cgh);
+        auto wb = b.get_access<access::mode::discard_write>(cgh);
+        accessor<float, 1, access::mode::read_write, access::target::local>
+            tile(group_size, cgh);
+        cgh.parallel_for<class local_copy>(
+            nd_range<1>(N, group_size), [=](nd_item<1> index) {
+              ++num_traced;
+              auto lid = index.get_local(0);
+              tile[lid] = ra[index.get_global(0)];
+              index.barrier(access::fence_space::local_space);
+              wb[index.get_global(0)] = tile[lid];
+            });
+      });
+    }
+  }
+  if (num_traced != 2) {
+    debug() << "local kernel traced" << num_traced << "times";
+    return 1;
+  }
+  for (int i = 0; i < N; ++i) {
+    if (local_out[i] != in[0][i]) {
+      debug() << "local" << i << "expected" << in[0][i] << "actual"
+              << local_out[i];
+      return 1;
+    }
+  }
+
+  return 0;
+}
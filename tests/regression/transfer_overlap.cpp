@@ -0,0 +1,56 @@
+#include "../common.h"
+
+// Copies of the next chunk overlapping the kernel of the current one
+
+using namespace cl::sycl;
+
+int main() {
+  static const int N = 1024;
+  static const int chunks = 4;
+
+  queue myQueue;
+  myQueue.set_transfer_overlap(true);
+  myQueue.set_submission_window(chunks);
+  if (!myQueue.get_transfer_overlap()) {
+    debug() << "transfer queue was not created";
+    return 1;
+  }
+
+  vector_class<vector_class<float>> in(chunks, vector_class<float>(N));
+  vector_class<vector_class<float>> out(chunks, vector_class<float>(N, 0));
+  for (int c = 0; c < chunks; ++c) {
+    for (int i = 0; i < N; ++i) {
+      in[c][i] = static_cast<float>(c * N + i);
+    }
+  }
+
+  {
+    vector_class<buffer<float>> ins, outs;
+    for (int c = 0; c < chunks; ++c) {
+      ins.emplace_back(in[c].data(), range<1>(N));
+      outs.emplace_back(out[c].data(), range<1>(N));
+    }
+
+    for (int c = 0; c < chunks; ++c) {
+      myQueue.submit([&](handler& cgh) {
+        auto a = ins[c].get_access<access::mode::read>(cgh);
+        auto b = outs[c].get_access<access::mode::discard_write>(cgh);
+        cgh.parallel_for<class square>(range<1>(N), [=](id<1> i) {
+          b[i] = a[i] * a[i];
+        });
+      });
+    }
+  }
+
+  for (int c = 0; c < chunks; ++c) {
+    for (int i = 0; i < N; ++i) {
+      auto expected = in[c][i] * in[c][i];
+      if (out[c][i] != expected) {
+        debug() << c << i << "expected" << expected << "actual" << out[c][i];
+        return 1;
+      }
+    }
+  }
+
+  return 0;
+}
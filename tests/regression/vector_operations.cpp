@@ -0,0 +1,62 @@
+#include "../common.h"
+
+// Test native vector arithmetic, comparison and conversion in kernel
+
+int main() {
+  using namespace cl::sycl;
+  using namespace std;
+
+  queue myQueue;
+
+  const int size = 16;
+  buffer<float4> results(size);
+  buffer<int4> comparisons(size);
+  buffer<int4> conversions(size);
+
+  myQueue.submit([&](handler& cgh) {
+    auto r = results.get_access<access::mode::discard_write>(cgh);
+    auto c = comparisons.get_access<access::mode::discard_write>(cgh);
+    auto v = conversions.get_access<access::mode::discard_write>(cgh);
+
+    cgh.parallel_for<class vector_ops>(range<1>(size), [=](id<> i) {
+      float4 a(1.5f, 2.5f, 3.5f, 4.5f);
+      float4 b = a * 2.0f;
+      b -= a;
+      b = -b / 0.5f + 2.0f * a;
+      b.xy() = a.hi();
+      r[i] = b;
+      c[i] = a < b;
+      v[i] = a.convert<int, rounding_mode::rtz>();
+    });
+  });
+
+  auto r =
+      results.get_access<access::mode::read, access::target::host_buffer>();
+  auto c =
+      comparisons.get_access<access::mode::read, access::target::host_buffer>();
+  auto v =
+      conversions.get_access<access::mode::read, access::target::host_buffer>();
+
+  const float expected[] = {3.5f, 4.5f, 0, 0};
+  const int expected_less[] = {-1, -1, 0, 0};
+  const int expected_int[] = {1, 2, 3, 4};
+
+  for (auto i = 0; i < size; ++i) {
+    auto ri = r[i];
+    auto ci = c[i];
+    auto vi = v[i];
+    const float got[] = {ri.x(), ri.y(), ri.z(), ri.w()};
+    const int got_less[] = {ci.x(), ci.y(), ci.z(), ci.w()};
+    const int got_int[] = {vi.x(), vi.y(), vi.z(), vi.w()};
+    for (auto j = 0; j < 4; ++j) {
+      if (got[j] != expected[j] || got_less[j] != expected_less[j] ||
+          got_int[j] != expected_int[j]) {
+        cout << i << ',' << j << " -> got " << got[j] << ' ' << got_less[j]
+             << ' ' << got_int[j] << endl;
+        return 1;
+      }
+    }
+  }
+
+  return 0;
+}